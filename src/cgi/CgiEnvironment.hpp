@@ -46,7 +46,7 @@ namespace CgiEnvironment {
         CgiEnvironmentMap& env_map, const std::string& client_ip = DEFAULT_CLIENT_IP,
         const std::string& client_host = DEFAULT_CLIENT_HOST);
 
-    inline void add_http_headers(const HeaderMap& headers, CgiEnvironmentMap& env_map);
+    inline void add_http_headers(const HeaderTable& headers, CgiEnvironmentMap& env_map);
 
     inline CgiEnvironmentVector map_to_vector(const CgiEnvironmentMap& env_map);
 
@@ -79,10 +79,8 @@ namespace CgiEnvironment {
         // Request method
         env_map["REQUEST_METHOD"] = HttpMethods::to_string(request.get_method());
 
-        // Request URI with query string
-        env_map["REQUEST_URI"] =
-            request.get_path() +
-            (request.get_query_string().empty() ? "" : "?" + request.get_query_string());
+        // Request URI with query string, as received
+        env_map["REQUEST_URI"] = request.get_request_uri();
 
         // Query string
         env_map["QUERY_STRING"] = request.get_query_string();
@@ -141,14 +139,17 @@ namespace CgiEnvironment {
     }
 
     inline void add_http_headers(
-        const HeaderMap& headers, std::map<std::string, std::string>& env_map) {
+        const HeaderTable& headers, std::map<std::string, std::string>& env_map) {
         // Group headers by name and combine multiple values with commas
         // as per RFC 3875 CGI specification
-        for (HeaderMapConstIt it = headers.begin(); it != headers.end(); ++it) {
+        for (size_t index = 0; index < headers.size(); ++index) {
+            HeaderTable::Slice name = headers.name_at(index);
+            HeaderTable::Slice value = headers.value_at(index);
+
             // Convert header name to CGI environment variable format
             std::string env_name = "HTTP_";
-            for (size_t i = 0; i < it->first.length(); ++i) {
-                char c = it->first[i];
+            for (size_t i = 0; i < name.length; ++i) {
+                char c = name.data[i];
                 if (c == '-') {
                     env_name += '_';
                 } else {
@@ -158,10 +159,11 @@ namespace CgiEnvironment {
 
             // If environment variable already exists, append with comma separator
             // This handles multiple headers with the same name per RFC 3875
-            if (env_map.find(env_name) != env_map.end()) {
-                env_map[env_name] += ", " + it->second;
+            CgiEnvironmentMap::iterator it = env_map.find(env_name);
+            if (it != env_map.end()) {
+                it->second.append(", ").append(value.data, value.length);
             } else {
-                env_map[env_name] = it->second;
+                env_map[env_name].assign(value.data, value.length);
             }
         }
     }
@@ -8,6 +8,7 @@
 
 #include "../server/Connection.hpp"
 #include "../server/EventPoller.hpp"
+#include "../utils/Clock.hpp"
 #include <sys/wait.h>
 
 CgiManager::CgiManager() {
@@ -30,7 +31,7 @@ CgiManager::~CgiManager() {
 }
 
 bool CgiManager::start_cgi_execution(
-    const HttpRequest& request, const std::string& script_path, const LocationBlock* location,
+    HttpRequest& request, const std::string& script_path, const LocationBlock* location,
     Connection* connection, EventPoller& poller) {
     // Check if CGI is already active for this connection
     std::map<Connection*, CgiState>::iterator it = cgi_states_.find(connection);
@@ -56,9 +57,9 @@ bool CgiManager::start_cgi_execution(
         pid_t pid;
         int stdout_fd, stdin_fd;
 
+        bool has_body = !request.get_body().empty();
         if (!CgiProcess::start_execution(
-                interpreter, script_path, env_vector, request.get_body(), pid, stdout_fd,
-                stdin_fd)) {
+                interpreter, script_path, env_vector, has_body, pid, stdout_fd, stdin_fd)) {
             return false;
         }
 
@@ -68,19 +69,28 @@ bool CgiManager::start_cgi_execution(
         cgi_state.pid = pid;
         cgi_state.stdout_fd = stdout_fd;
         cgi_state.stdin_fd = stdin_fd;
-        cgi_state.start_time = time(NULL);
-        cgi_state.cgi_request = request;
+        cgi_state.start_time_ms = Clock::now_ms();
+        cgi_state.request_body.clear();
+        request.swap_body(cgi_state.request_body);
+        cgi_state.request_body_sent = 0;
         cgi_state.location = location;
         cgi_state.accumulated_output.clear();
+        cgi_state.streaming = false;
+        cgi_state.stream_ended = false;
 
         // Add stdout_fd to event polling for reading
-        poller.watch_fd(stdout_fd, PollEvents::READ);
+        poller.watch_fd(stdout_fd, PollEvents::READ, FdOwner(FdOwner::CGI_STDOUT, connection));
 
         // If we have a request body and stdin is still open, watch stdin for writing
-        if (stdin_fd != -1 && !request.get_body().empty()) {
-            poller.watch_fd(stdin_fd, PollEvents::WRITE);
+        if (stdin_fd != -1 && has_body) {
+            poller.watch_fd(stdin_fd, PollEvents::WRITE, FdOwner(FdOwner::CGI_STDIN, connection));
         }
 
+        // The CGI timer drives the timeout and the final reap
+        poller.set_timer(
+            connection->get_fd(), Timers::CGI,
+            cgi_state.start_time_ms + CGI_TIMEOUT_SECONDS * 1000);
+
         return true;
 
     } catch (const std::exception& e) {
@@ -101,9 +111,26 @@ bool CgiManager::handle_cgi_completion(Connection* connection, EventPoller& poll
     pid_t result = waitpid(cgi_state.pid, &status, WNOHANG);
 
     if (result == cgi_state.pid) {
-        // Process completed
-        close(cgi_state.stdout_fd);
-        poller.unwatch_fd(cgi_state.stdout_fd);
+        // Process completed: collect any output still buffered in the pipe
+        if (cgi_state.stdout_fd != -1) {
+            char buffer[CGI_BUFFER_SIZE];
+            ssize_t bytes_read;
+            while ((bytes_read = read(cgi_state.stdout_fd, buffer, sizeof(buffer))) > 0) {
+                cgi_state.accumulated_output.append(buffer, bytes_read);
+            }
+        }
+        poller.cancel_timer(connection->get_fd(), Timers::CGI);
+        close_cgi_fds(cgi_state, poller);
+
+        if (cgi_state.streaming) {
+            // The response is already underway, a failure can only cut the connection
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                Log::error("Streamed CGI process exited abnormally, closing connection");
+                connection->close_after_response();
+            }
+            reset_cgi_state(connection);
+            return true;
+        }
 
         // Check process exit status before building response
         if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
@@ -125,7 +152,7 @@ bool CgiManager::handle_cgi_completion(Connection* connection, EventPoller& poll
             HttpResponse response = CgiResponse::build_from_output(cgi_state.accumulated_output);
 
             // Set the response on the connection for sending to client
-            connection->set_response_from_cgi(response.build());
+            connection->set_response_from_cgi(response);
 
         } catch (const std::exception& e) {
             Log::error("Failed to build CGI response: " + std::string(e.what()));
@@ -148,11 +175,14 @@ bool CgiManager::handle_cgi_timeout(Connection* connection, EventPoller& poller)
     }
 
     CgiState& cgi_state = it->second;
-    time_t current_time = time(NULL);
 
-    if (current_time - cgi_state.start_time >= CGI_TIMEOUT_SECONDS) {
-        // Send timeout error response before cleanup
-        send_cgi_error_response(connection, GATEWAY_TIMEOUT, "CGI script timeout");
+    if (Clock::now_ms() >= get_deadline_ms(cgi_state)) {
+        // Send timeout error response before cleanup, unless the headers are already out
+        if (cgi_state.streaming) {
+            connection->abort_response();
+        } else {
+            send_cgi_error_response(connection, GATEWAY_TIMEOUT, "CGI script timeout");
+        }
 
         // Clean up the CGI process
         cleanup_cgi_process(connection, poller);
@@ -166,8 +196,84 @@ bool CgiManager::handle_cgi_timeout(Connection* connection, EventPoller& poller)
 
 void CgiManager::update_cgi_process(Connection* connection, EventPoller& poller) {
     // Try completion first, then timeout if not completed
-    if (!handle_cgi_completion(connection, poller)) {
-        handle_cgi_timeout(connection, poller);
+    if (handle_cgi_completion(connection, poller) || handle_cgi_timeout(connection, poller)) {
+        return;
+    }
+
+    // Still running: once its output is closed only the reap is missing, retry shortly
+    const CgiState& cgi_state = cgi_states_[connection];
+    long deadline_ms = get_deadline_ms(cgi_state);
+    if (cgi_state.stdout_fd == -1 && (!cgi_state.streaming || cgi_state.stream_ended)) {
+        deadline_ms = std::min(deadline_ms, Clock::now_ms() + CGI_REAP_RETRY_MS);
+    }
+    poller.set_timer(connection->get_fd(), Timers::CGI, deadline_ms);
+}
+
+// The whole run until streaming starts, then the time without output: a long download
+// from a script that keeps producing is not cut off
+long CgiManager::get_deadline_ms(const CgiState& cgi_state) {
+    long since_ms = cgi_state.streaming ? cgi_state.last_output_ms : cgi_state.start_time_ms;
+    return since_ms + CGI_TIMEOUT_SECONDS * 1000;
+}
+
+void CgiManager::handle_cgi_output_end(Connection* connection, EventPoller& poller) {
+    if (handle_cgi_completion(connection, poller)) {
+        return;
+    }
+
+    // Output is complete but the process has not exited yet: stop watching the pipe
+    // (it would report EOF on every wait) and let the CGI timer reap the process
+    CgiState& cgi_state = cgi_states_[connection];
+    poller.unwatch_fd(cgi_state.stdout_fd);
+    close(cgi_state.stdout_fd);
+    cgi_state.stdout_fd = -1;
+    poller.set_timer(connection->get_fd(), Timers::CGI, Clock::now_ms() + CGI_REAP_RETRY_MS);
+}
+
+void CgiManager::start_streaming(Connection* connection, EventPoller& poller) {
+    CgiState& cgi_state = cgi_states_[connection];
+    if (CgiResponse::find_header_end(cgi_state.accumulated_output) == std::string::npos) {
+        return;  // Headers still incomplete, keep buffering
+    }
+
+    HeaderMap headers;
+    std::string body;
+    CgiResponse::parse_cgi_output(cgi_state.accumulated_output, headers, body);
+    HttpResponse response = CgiResponse::build_response(headers, "");
+
+    // A Content-Length from the script is kept, otherwise the body is sent chunked
+    off_t length = BodySource::UNKNOWN_LENGTH;
+    std::string content_length = HttpHeaders::get(headers, HttpHeaders::CONTENT_LENGTH);
+    if (HttpHeaders::is_valid_content_length(content_length)) {
+        length = static_cast<off_t>(std::strtol(content_length.c_str(), NULL, 10));
+    }
+
+    // The pipe now belongs to the response body, the Connection watches it when needed
+    poller.unwatch_fd(cgi_state.stdout_fd);
+    response.set_body_source(new PipeBodySource(cgi_state.stdout_fd, body, length));
+    cgi_state.stdout_fd = -1;
+    cgi_state.streaming = true;
+    cgi_state.last_output_ms = Clock::now_ms();
+    cgi_state.accumulated_output.clear();
+
+    Log::debug("CGI output exceeds the buffer, streaming the rest of the response");
+    connection->set_response_from_cgi(response);
+}
+
+void CgiManager::handle_stream_end(Connection* connection, EventPoller& poller) {
+    std::map<Connection*, CgiState>::iterator it = cgi_states_.find(connection);
+    if (it == cgi_states_.end() || !it->second.active || !it->second.streaming) {
+        return;
+    }
+    it->second.stream_ended = true;
+    update_cgi_process(connection, poller);
+}
+
+void CgiManager::handle_stream_output(Connection* connection) {
+    // Only recorded: the CGI timer pushes its deadline when it fires
+    std::map<Connection*, CgiState>::iterator it = cgi_states_.find(connection);
+    if (it != cgi_states_.end() && it->second.active && it->second.streaming) {
+        it->second.last_output_ms = Clock::now_ms();
     }
 }
 
@@ -179,9 +285,14 @@ void CgiManager::cleanup_cgi_process(Connection* connection, EventPoller& poller
 
     CgiState& cgi_state = it->second;
 
-    Log::warn(
-        "Cleaning up active CGI process (pid: " + Log::to_string(cgi_state.pid) +
-        ") due to connection close or timeout");
+    if (cgi_state.stream_ended) {
+        // Its whole output was delivered, only the exit was still pending
+        Log::debug("Reaping streamed CGI process (pid: " + Log::to_string(cgi_state.pid) + ")");
+    } else {
+        Log::warn(
+            "Cleaning up active CGI process (pid: " + Log::to_string(cgi_state.pid) +
+            ") due to connection close or timeout");
+    }
 
     // Kill the CGI process
     if (cgi_state.pid > 0) {
@@ -189,14 +300,9 @@ void CgiManager::cleanup_cgi_process(Connection* connection, EventPoller& poller
         waitpid(cgi_state.pid, NULL, 0);
     }
 
-    // Cleanup CGI file descriptors
-    if (cgi_state.stdout_fd != -1) {
-        close(cgi_state.stdout_fd);
-        poller.unwatch_fd(cgi_state.stdout_fd);
-    }
-    if (cgi_state.stdin_fd != -1) {
-        close(cgi_state.stdin_fd);
-    }
+    // Cleanup CGI file descriptors and the CGI timer
+    close_cgi_fds(cgi_state, poller);
+    poller.cancel_timer(connection->get_fd(), Timers::CGI);
 
     // Reset CGI state
     reset_cgi_state(connection);
@@ -217,9 +323,14 @@ bool CgiManager::process_cgi_output(
         ssize_t bytes_read = read(cgi_fd, buffer, sizeof(buffer));
         if (bytes_read > 0) {
             cgi_state.accumulated_output.append(buffer, bytes_read);
+
+            // Large outputs are forwarded as they come instead of held until the exit
+            if (cgi_state.accumulated_output.size() >= CGI_STREAM_THRESHOLD) {
+                start_streaming(connection, poller);
+            }
         } else if (bytes_read == 0) {
             // EOF - CGI process finished
-            handle_cgi_completion(connection, poller);
+            handle_cgi_output_end(connection, poller);
         } else {
             // bytes_read < 0 - could be EAGAIN/EWOULDBLOCK (expected) or real error
             // Subject forbids checking errno, so we handle this gracefully
@@ -229,7 +340,10 @@ bool CgiManager::process_cgi_output(
         }
     } else if (event.has_error) {
         Log::error("Error event on CGI fd: " + Log::to_string(cgi_fd));
-        handle_cgi_completion(connection, poller);
+        handle_cgi_output_end(connection, poller);
+    } else if (event.has_hup) {
+        // Writer closed the pipe with nothing left to read
+        handle_cgi_output_end(connection, poller);
     }
 
     return true;
@@ -245,29 +359,28 @@ bool CgiManager::process_cgi_input(
     CgiState& cgi_state = it->second;
 
     if (event.can_write) {
-        // Send request body data to CGI stdin
-        const std::string& request_body = cgi_state.cgi_request.get_body();
+        // Send request body data to CGI stdin, from memory or from the spooled file
+        const RequestBody& request_body = cgi_state.request_body;
 
-        if (cgi_state.request_body_sent < request_body.length()) {
+        if (cgi_state.request_body_sent < request_body.size()) {
             // Send remaining data
-            size_t remaining = request_body.length() - cgi_state.request_body_sent;
-            const char* data = request_body.c_str() + cgi_state.request_body_sent;
-
-            ssize_t written = write(cgi_fd, data, remaining);
+            size_t remaining = request_body.size() - cgi_state.request_body_sent;
+            ssize_t written =
+                request_body.write_to(cgi_fd, cgi_state.request_body_sent, remaining);
             if (written > 0) {
                 cgi_state.request_body_sent += written;
 
                 // Check if we've sent all the data
-                if (cgi_state.request_body_sent >= request_body.length()) {
+                if (cgi_state.request_body_sent >= request_body.size()) {
                     // All data sent, close stdin and stop watching it
-                    close(cgi_fd);
                     poller.unwatch_fd(cgi_fd);
+                    close(cgi_fd);
                     cgi_state.stdin_fd = -1;
                 }
             } else if (written == 0) {
                 // Pipe closed unexpectedly
-                close(cgi_fd);
                 poller.unwatch_fd(cgi_fd);
+                close(cgi_fd);
                 cgi_state.stdin_fd = -1;
             } else {
                 // written < 0 - could be EAGAIN/EWOULDBLOCK (expected) or real error
@@ -277,14 +390,14 @@ bool CgiManager::process_cgi_input(
             }
         } else {
             // All data already sent, close stdin
-            close(cgi_fd);
             poller.unwatch_fd(cgi_fd);
+            close(cgi_fd);
             cgi_state.stdin_fd = -1;
         }
     } else if (event.has_error) {
         Log::error("Error event on CGI stdin fd: " + Log::to_string(cgi_fd));
-        close(cgi_fd);
         poller.unwatch_fd(cgi_fd);
+        close(cgi_fd);
         cgi_state.stdin_fd = -1;
     }
 
@@ -311,6 +424,19 @@ CgiManager::CgiState& CgiManager::get_cgi_state(Connection* connection) {
     return cgi_states_[connection];
 }
 
+void CgiManager::close_cgi_fds(CgiState& cgi_state, EventPoller& poller) {
+    if (cgi_state.stdout_fd != -1) {
+        poller.unwatch_fd(cgi_state.stdout_fd);
+        close(cgi_state.stdout_fd);
+        cgi_state.stdout_fd = -1;
+    }
+    if (cgi_state.stdin_fd != -1) {
+        poller.unwatch_fd(cgi_state.stdin_fd);
+        close(cgi_state.stdin_fd);
+        cgi_state.stdin_fd = -1;
+    }
+}
+
 void CgiManager::reset_cgi_state(Connection* connection) {
     std::map<Connection*, CgiState>::iterator it = cgi_states_.find(connection);
     if (it != cgi_states_.end()) {
@@ -318,9 +444,13 @@ void CgiManager::reset_cgi_state(Connection* connection) {
         it->second.pid = -1;
         it->second.stdout_fd = -1;
         it->second.stdin_fd = -1;
-        it->second.start_time = 0;
+        it->second.start_time_ms = 0;
+        it->second.last_output_ms = 0;
         it->second.location = NULL;
         it->second.accumulated_output.clear();
+        it->second.request_body.clear();
+        it->second.streaming = false;
+        it->second.stream_ended = false;
         // We could erase the entry entirely, but keeping it allows for potential reuse
         // cgi_states_.erase(it);
     }
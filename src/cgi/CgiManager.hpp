@@ -39,39 +39,52 @@ class CgiManager {
         pid_t pid;
         int stdout_fd;
         int stdin_fd;
-        time_t start_time;
+        long start_time_ms;   // Monotonic start time (Clock::now_ms)
+        long last_output_ms;  // Last streamed output read, the timeout counts from there
         std::string accumulated_output;
-        HttpRequest cgi_request;
+        RequestBody request_body;  // Taken over from the request, fed to the CGI stdin
         const LocationBlock* location;
         size_t request_body_sent;  // Track how much of the request body has been sent
+        bool streaming;            // Headers sent, stdout now read by the Connection
+        bool stream_ended;         // The Connection reached EOF on the streamed output
 
         CgiState()
             : active(false),
               pid(-1),
               stdout_fd(-1),
               stdin_fd(-1),
-              start_time(0),
+              start_time_ms(0),
+              last_output_ms(0),
               location(NULL),
-              request_body_sent(0) {
+              request_body_sent(0),
+              streaming(false),
+              stream_ended(false) {
         }
     };
 
     CgiManager();
     ~CgiManager();
 
-    // Core CGI functionality
+    // Core CGI functionality. The request's body moves into the CGI state, the request
+    // keeps everything else for the response
     bool start_cgi_execution(
-        const HttpRequest& request, const std::string& script_path, const LocationBlock* location,
+        HttpRequest& request, const std::string& script_path, const LocationBlock* location,
         Connection* connection, EventPoller& poller);
 
     bool handle_cgi_completion(Connection* connection, EventPoller& poller);
     bool handle_cgi_timeout(Connection* connection, EventPoller& poller);
 
-    // Convenience method that checks completion first, then timeout
+    // CGI timer callback: checks completion first, then timeout, then re-arms the timer
     void update_cgi_process(Connection* connection, EventPoller& poller);
 
     void cleanup_cgi_process(Connection* connection, EventPoller& poller);
 
+    // The Connection finished a body: reap a streamed CGI as soon as it exits
+    void handle_stream_end(Connection* connection, EventPoller& poller);
+
+    // The Connection read streamed output: the CGI is alive, its timeout starts over
+    void handle_stream_output(Connection* connection);
+
     // CGI I/O processing
     bool process_cgi_output(
         int cgi_fd, Connection* connection, EventPoller& poller, const PollResult& event);
@@ -86,12 +99,18 @@ class CgiManager {
    private:
     // CGI execution constants
     static const int CGI_TIMEOUT_SECONDS = 5;    // CGI process timeout in seconds
+    static const long CGI_REAP_RETRY_MS = 10;    // Retry interval for reaping after output EOF
     static const size_t CGI_BUFFER_SIZE = 8192;  // Buffer size for reading CGI output
+    static const size_t CGI_STREAM_THRESHOLD = 65536;  // Buffered output before streaming
 
     // Map to store CGI state for each connection
     std::map<Connection*, CgiState> cgi_states_;
 
     // Helper methods
+    void handle_cgi_output_end(Connection* connection, EventPoller& poller);
+    void start_streaming(Connection* connection, EventPoller& poller);
+    static long get_deadline_ms(const CgiState& cgi_state);
+    void close_cgi_fds(CgiState& cgi_state, EventPoller& poller);
     void reset_cgi_state(Connection* connection);
     void send_cgi_error_response(
         Connection* connection, HttpStatusCode status, const std::string& message);
@@ -10,7 +10,6 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <iostream>
 #include <string>
 #include <vector>
 
@@ -37,8 +36,9 @@ namespace CgiProcess {
     // Helper functions
     inline void create_pipes(int stdin_pipe[2], int stdout_pipe[2]);
     inline void execute_child_process(
-        const std::string& interpreter, const std::string& absolute_script_path, char** envp,
+        const char* program, char* const argv[], const char* script_dir, char** envp,
         int stdin_pipe[2], int stdout_pipe[2]);
+    inline void write_child_error(const char* message, size_t length);
     inline std::string get_absolute_path(const std::string& script_path);
     inline char** vector_to_envp(const std::vector<std::string>& env_vector);
     inline void free_envp(char** envp);
@@ -48,7 +48,7 @@ namespace CgiProcess {
     // Non-blocking CGI execution for server integration
     inline bool start_execution(
         const std::string& interpreter, const std::string& script_path,
-        const std::vector<std::string>& env_vector, const std::string& request_body, pid_t& out_pid,
+        const std::vector<std::string>& env_vector, bool has_request_body, pid_t& out_pid,
         int& out_stdout_fd, int& out_stdin_fd);
 
     // Implementation
@@ -56,13 +56,30 @@ namespace CgiProcess {
     // Non-blocking CGI execution starter
     inline bool start_execution(
         const std::string& interpreter, const std::string& script_path,
-        const std::vector<std::string>& env_vector, const std::string& request_body, pid_t& out_pid,
+        const std::vector<std::string>& env_vector, bool has_request_body, pid_t& out_pid,
         int& out_stdout_fd, int& out_stdin_fd) {
         char** envp = vector_to_envp(env_vector);
 
         try {
             std::string absolute_script_path = get_absolute_path(script_path);
 
+            // Everything the child needs is built before fork(): another thread may hold the
+            // allocator lock at that moment, so the child must not allocate
+            std::string script_dir = get_script_directory(absolute_script_path);
+            std::string script_filename = get_script_filename(absolute_script_path);
+            const std::string& program = interpreter.empty() ? absolute_script_path : interpreter;
+            char* argv[3];
+            if (interpreter.empty()) {
+                // Direct execution for .cgi files
+                argv[0] = const_cast<char*>(absolute_script_path.c_str());
+                argv[1] = NULL;
+            } else {
+                // Interpreted execution for other scripts, run from the script directory
+                argv[0] = const_cast<char*>(interpreter.c_str());
+                argv[1] = const_cast<char*>(script_filename.c_str());
+            }
+            argv[2] = NULL;
+
             // Create pipes for communication
             int stdin_pipe[2];
             int stdout_pipe[2];
@@ -81,7 +98,7 @@ namespace CgiProcess {
             if (pid == 0) {
                 // Child process
                 execute_child_process(
-                    interpreter, absolute_script_path, envp, stdin_pipe, stdout_pipe);
+                    program.c_str(), argv, script_dir.c_str(), envp, stdin_pipe, stdout_pipe);
             }
 
             // Parent process - setup for non-blocking monitoring
@@ -99,10 +116,10 @@ namespace CgiProcess {
             out_pid = pid;
             out_stdout_fd = stdout_pipe[0];
             out_stdin_fd =
-                request_body.empty() ? -1 : stdin_pipe[1];  // Keep stdin open if we have body data
+                has_request_body ? stdin_pipe[1] : -1;  // Keep stdin open if we have body data
 
             // Close stdin immediately if no request body (common case)
-            if (request_body.empty()) {
+            if (!has_request_body) {
                 close(stdin_pipe[1]);
             }
 
@@ -130,6 +147,12 @@ namespace CgiProcess {
     }
 
     inline void create_pipes(int stdin_pipe[2], int stdout_pipe[2]) {
+#ifdef __linux__
+        // Atomic FD_CLOEXEC: another reactor thread may fork a CGI between pipe() and fcntl()
+        if (pipe2(stdin_pipe, O_CLOEXEC) == -1 || pipe2(stdout_pipe, O_CLOEXEC) == -1) {
+            throw HttpError(INTERNAL_SERVER_ERROR, "Failed to create pipes for CGI");
+        }
+#else
         if (pipe(stdin_pipe) == -1 || pipe(stdout_pipe) == -1) {
             throw HttpError(INTERNAL_SERVER_ERROR, "Failed to create pipes for CGI");
         }
@@ -139,11 +162,18 @@ namespace CgiProcess {
         fcntl(stdin_pipe[1], F_SETFD, FD_CLOEXEC);
         fcntl(stdout_pipe[0], F_SETFD, FD_CLOEXEC);
         fcntl(stdout_pipe[1], F_SETFD, FD_CLOEXEC);
+#endif
     }
 
+    // Runs in the forked child of a multithreaded process: only async-signal-safe calls
     inline void execute_child_process(
-        const std::string& interpreter, const std::string& absolute_script_path, char** envp,
+        const char* program, char* const argv[], const char* script_dir, char** envp,
         int stdin_pipe[2], int stdout_pipe[2]) {
+        // Reactor threads block SIGINT/SIGTERM, the script starts with an empty signal mask
+        sigset_t empty_mask;
+        sigemptyset(&empty_mask);
+        sigprocmask(SIG_SETMASK, &empty_mask, NULL);
+
         // Redirect stdin and stdout
         dup2(stdin_pipe[0], STDIN_FILENO);
         dup2(stdout_pipe[1], STDOUT_FILENO);
@@ -159,35 +189,24 @@ namespace CgiProcess {
         // for manual cleanup loop. This is cleaner and more reliable.
 
         // Change to script directory
-        std::string script_dir = get_script_directory(absolute_script_path);
-        if (chdir(script_dir.c_str()) == -1) {
-            std::cerr << "CGI: Failed to change directory to " << script_dir << std::endl;
-            exit(1);
+        if (chdir(script_dir) == -1) {
+            static const char message[] = "CGI: Failed to change to the script directory\n";
+            write_child_error(message, sizeof(message) - 1);
+            _exit(1);
         }
 
-        // Prepare arguments for execve
-        const char* argv[3];
-
-        if (interpreter.empty()) {
-            // Direct execution for .cgi files
-            argv[0] = absolute_script_path.c_str();
-            argv[1] = NULL;
-            execve(absolute_script_path.c_str(), const_cast<char**>(argv), envp);
-        } else {
-            // Interpreted execution for other scripts
-            argv[0] = interpreter.c_str();
-
-            // Store filename in persistent variable to avoid dangling pointer
-            std::string script_filename = get_script_filename(absolute_script_path);
-            argv[1] = script_filename.c_str();
-            argv[2] = NULL;
-
-            execve(interpreter.c_str(), const_cast<char**>(argv), envp);
-        }
+        execve(program, argv, envp);
 
         // If we get here, execve failed
-        std::cerr << "CGI: execve failed: " << strerror(errno) << std::endl;
-        exit(1);
+        static const char message[] = "CGI: execve failed\n";
+        write_child_error(message, sizeof(message) - 1);
+        _exit(1);
+    }
+
+    // write(2) instead of std::cerr, which may allocate or wait on a lock held at fork time
+    inline void write_child_error(const char* message, size_t length) {
+        ssize_t written = write(STDERR_FILENO, message, length);
+        (void)written;
     }
 
     inline char** vector_to_envp(const std::vector<std::string>& env_vector) {
@@ -26,6 +26,8 @@ namespace CgiResponse {
 
     inline HttpResponse build_from_output(const std::string& cgi_output);
 
+    inline size_t find_header_end(const std::string& cgi_output);
+
     inline void parse_cgi_output(
         const std::string& cgi_output, HeaderMap& headers, std::string& body);
 
@@ -44,22 +46,30 @@ namespace CgiResponse {
         return build_response(headers, body);
     }
 
+    // Offset just past the blank line ending the headers, npos while there is none
+    inline size_t find_header_end(const std::string& cgi_output) {
+        size_t header_end = cgi_output.find("\r\n\r\n");
+        if (header_end != std::string::npos) {
+            return header_end + 4;  // Skip \r\n\r\n
+        }
+
+        // Try Unix line endings
+        header_end = cgi_output.find("\n\n");
+        if (header_end != std::string::npos) {
+            return header_end + 2;  // Skip the two newlines
+        }
+        return std::string::npos;
+    }
+
     inline void parse_cgi_output(
         const std::string& cgi_output, std::multimap<std::string, std::string>& headers,
         std::string& body) {
         // Find the header/body separator (blank line)
-        size_t header_end = cgi_output.find("\r\n\r\n");
+        size_t header_end = find_header_end(cgi_output);
         if (header_end == std::string::npos) {
-            // Try Unix line endings
-            header_end = cgi_output.find("\n\n");
-            if (header_end == std::string::npos) {
-                // No headers, entire output is body
-                body = cgi_output;
-                return;
-            }
-            header_end += 2;  // Skip the two newlines
-        } else {
-            header_end += 4;  // Skip \r\n\r\n
+            // No headers, entire output is body
+            body = cgi_output;
+            return;
         }
 
         // Parse headers
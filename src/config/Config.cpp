@@ -18,18 +18,23 @@ static const int DEFAULT_MAIN_PORT = 4242;     // Port for main default server
 namespace Config {
 
     // Public API implementation
-    void load_config(const std::string& filename, std::vector<ServerBlock>& server_blocks) {
+    void load_config(
+        const std::string& filename, std::vector<ServerBlock>& server_blocks,
+        GlobalBlock& global_block) {
         // If no filename is specified, load default configuration
         if (filename.empty()) {
             internal::load_default_config(server_blocks);
+            internal::compile_locations(server_blocks);
             return;
         }
 
         try {
             ConfigParser parser;
             server_blocks = parser.parse(filename);
+            global_block = parser.get_global_block();
             internal::inherit_client_max_body_size(server_blocks);
             internal::validate_server_blocks(server_blocks);
+            internal::compile_locations(server_blocks);
         } catch (const std::exception& e) {
             Log::error(e.what());
             throw std::runtime_error("Configuration file is not valid");
@@ -51,6 +56,13 @@ namespace Config {
             }
         }
 
+        void compile_locations(std::vector<ServerBlock>& server_blocks) {
+            for (ServerBlockVectorIt server = server_blocks.begin(); server != server_blocks.end();
+                 ++server) {
+                server->compile_locations();
+            }
+        }
+
         void validate_location_roots(const ServerBlock& server) {
             // For each location without its own root, ensure server has one
             for (LocationBlockVectorConstIt loc = server.locations.begin();
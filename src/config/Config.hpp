@@ -6,12 +6,14 @@
 #include <string>
 #include <vector>
 
+#include "../config/contexts/GlobalBlock.hpp"
 #include "../config/contexts/ServerBlock.hpp"
 #include "../utils/Types.hpp"
 
 namespace Config {
     // Main interface methods - public API
-    void load_config(const std::string& filename, ServerBlockVector& server_blocks);
+    void load_config(
+        const std::string& filename, ServerBlockVector& server_blocks, GlobalBlock& global_block);
 
     // Internal implementation namespace - not meant for public use
     namespace internal {
@@ -24,6 +26,9 @@ namespace Config {
         // Directive inheritance
         void inherit_client_max_body_size(ServerBlockVector& server_blocks);
 
+        // Location matchers and method masks, once the locations are final
+        void compile_locations(ServerBlockVector& server_blocks);
+
         // Fallback configuration
         void load_default_config(ServerBlockVector& server_blocks);
     }  // namespace internal
@@ -0,0 +1,116 @@
+#include "GlobalBlock.hpp"
+
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "../../http/request/RequestBody.hpp"
+#include <sys/stat.h>
+
+// Default configuration constants
+#ifdef __linux__
+static const char DEFAULT_EVENT_BACKEND[] = "epoll";
+#else
+static const char DEFAULT_EVENT_BACKEND[] = "poll";
+#endif
+static const int DEFAULT_MAX_CONNECTIONS = 1024;
+static const int DEFAULT_ACCEPT_BATCH = 64;
+static const size_t DEFAULT_HEADER_BUFFER_SIZE = 1024;
+static const size_t DEFAULT_HEADER_MAX_SIZE = 16384;
+static const char DEFAULT_BODY_TEMP_PATH[] = "/tmp";
+
+const int GlobalBlock::MAX_WORKER_PROCESSES;
+const int GlobalBlock::MAX_REACTOR_THREADS;
+const int GlobalBlock::MAX_ACCEPT_BATCH;
+const size_t GlobalBlock::MIN_HEADER_BUFFER_SIZE;
+const size_t GlobalBlock::MAX_HEADER_SIZE_LIMIT;
+const size_t GlobalBlock::MIN_BODY_BUFFER_SIZE;
+
+GlobalBlock::GlobalBlock()
+    : event_backend(DEFAULT_EVENT_BACKEND),
+      edge_triggered(false),
+      worker_processes(1),
+      worker_cpu_affinity(false),
+      reactor_threads(1),
+      reactor_balance("round_robin"),
+      max_connections(DEFAULT_MAX_CONNECTIONS),
+      accept_batch(DEFAULT_ACCEPT_BATCH),
+      client_header_buffer_size(DEFAULT_HEADER_BUFFER_SIZE),
+      client_header_max_size(DEFAULT_HEADER_MAX_SIZE),
+      client_body_buffer_size(RequestBody::DEFAULT_BUFFER_SIZE),
+      client_body_temp_path(DEFAULT_BODY_TEMP_PATH) {
+}
+
+void GlobalBlock::is_valid() const {
+    validate_event_backend();
+    validate_worker_processes();
+    validate_reactor_threads();
+    validate_admission();
+    validate_header_buffers();
+    validate_body_buffering();
+}
+
+void GlobalBlock::validate_event_backend() const {
+    if (event_backend != "epoll" && event_backend != "poll" && event_backend != "io_uring") {
+        throw std::runtime_error(
+            "Invalid event_backend: " + event_backend + " (must be epoll, io_uring or poll)");
+    }
+
+    if (edge_triggered && event_backend != "epoll") {
+        throw std::runtime_error("edge_triggered requires the epoll event_backend");
+    }
+}
+
+void GlobalBlock::validate_worker_processes() const {
+    if (worker_processes < 1 || worker_processes > MAX_WORKER_PROCESSES) {
+        throw std::runtime_error("worker_processes must be between 1 and 512");
+    }
+}
+
+void GlobalBlock::validate_reactor_threads() const {
+    if (reactor_threads < 1 || reactor_threads > MAX_REACTOR_THREADS) {
+        throw std::runtime_error("reactor_threads must be between 1 and 512");
+    }
+
+    if (reactor_balance != "round_robin" && reactor_balance != "least_loaded") {
+        throw std::runtime_error(
+            "Invalid reactor_balance: " + reactor_balance +
+            " (must be round_robin or least_loaded)");
+    }
+}
+
+void GlobalBlock::validate_admission() const {
+    if (max_connections < 1) {
+        throw std::runtime_error("max_connections must be greater than zero");
+    }
+
+    if (accept_batch < 1 || accept_batch > MAX_ACCEPT_BATCH) {
+        throw std::runtime_error("accept_batch must be between 1 and 4096");
+    }
+}
+
+void GlobalBlock::validate_header_buffers() const {
+    if (client_header_buffer_size < MIN_HEADER_BUFFER_SIZE) {
+        throw std::runtime_error("client_header_buffer_size must be at least 256 bytes");
+    }
+
+    if (client_header_max_size < client_header_buffer_size ||
+        client_header_max_size > MAX_HEADER_SIZE_LIMIT) {
+        throw std::runtime_error(
+            "client_header_max_size must be between client_header_buffer_size and 1m");
+    }
+}
+
+void GlobalBlock::validate_body_buffering() const {
+    if (client_body_buffer_size < MIN_BODY_BUFFER_SIZE) {
+        throw std::runtime_error("client_body_buffer_size must be at least 1024 bytes");
+    }
+
+    // Checked at startup rather than on the first large upload
+    struct stat info;
+    if (stat(client_body_temp_path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) ||
+        access(client_body_temp_path.c_str(), W_OK | X_OK) != 0) {
+        throw std::runtime_error(
+            "client_body_temp_path must be a writable directory: " + client_body_temp_path);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GLOBAL_BLOCK_HPP
+#define GLOBAL_BLOCK_HPP
+
+#include <string>
+
+#include "../../utils/Types.hpp"
+
+// Directives of the main context (outside any server block)
+class GlobalBlock {
+   public:
+    GlobalBlock();
+
+    // Event loop configuration
+    std::string event_backend;  // Readiness backend: "epoll", "io_uring" or "poll"
+    bool edge_triggered;        // Edge-triggered notifications for client sockets (epoll only)
+
+    // Process model
+    int worker_processes;      // Number of worker processes, 1 runs everything in-process
+    bool worker_cpu_affinity;  // Pin worker i to CPU i (modulo online CPUs)
+    int reactor_threads;       // Event loop threads per process, 1 serves from the main thread
+    std::string reactor_balance;  // Handoff policy: "round_robin" or "least_loaded"
+
+    // Connection admission
+    int max_connections;  // Open client connections per worker process before accepts pause
+    int accept_batch;     // Connections accepted per listener wakeup
+
+    // Receive buffers
+    size_t client_header_buffer_size;  // Initial receive buffer of a connection
+    size_t client_header_max_size;     // Largest request line + headers accepted (431 beyond)
+
+    // Request bodies
+    size_t client_body_buffer_size;     // Body bytes kept in memory, larger bodies are spooled
+    std::string client_body_temp_path;  // Directory of the spooled bodies' temporary files
+
+    // Limits
+    static const int MAX_WORKER_PROCESSES = 512;
+    static const int MAX_REACTOR_THREADS = 512;
+    static const int MAX_ACCEPT_BATCH = 4096;
+    static const size_t MIN_HEADER_BUFFER_SIZE = 256;
+    static const size_t MAX_HEADER_SIZE_LIMIT = 1048576;
+    static const size_t MIN_BODY_BUFFER_SIZE = 1024;
+
+    // Validation methods - throws exceptions with descriptive error messages
+    void is_valid() const;
+
+   private:
+    void validate_event_backend() const;
+    void validate_worker_processes() const;
+    void validate_reactor_threads() const;
+    void validate_admission() const;
+    void validate_header_buffers() const;
+    void validate_body_buffering() const;
+};
+
+#endif  // GLOBAL_BLOCK_HPP
@@ -1,6 +1,5 @@
 #include "LocationBlock.hpp"
 
-#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -9,6 +8,7 @@ static const size_t DEFAULT_CLIENT_MAX_BODY_SIZE = 1024 * 1024;  // 1MB default
 
 LocationBlock::LocationBlock()
     : exact_match(false),
+      allowed_method_mask(1u << HttpMethods::GET),
       autoindex(false),
       redirect_status_code(0),
       client_max_body_size(DEFAULT_CLIENT_MAX_BODY_SIZE),  // 1MB default
@@ -25,10 +25,15 @@ void LocationBlock::is_valid() const {
     validate_cgi_configuration();
 }
 
+void LocationBlock::compile_method_mask() {
+    allowed_method_mask = 0;
+    for (size_t i = 0; i < allowed_methods.size(); ++i) {
+        allowed_method_mask |= 1u << allowed_methods[i];
+    }
+}
+
 bool LocationBlock::is_allows_method(HttpMethods::Method method) const {
-    // Search for method in allowed methods vector
-    return std::find(allowed_methods.begin(), allowed_methods.end(), method) !=
-           allowed_methods.end();
+    return (allowed_method_mask >> method) & 1u;
 }
 
 std::string LocationBlock::get_allowed_methods_string() const {
@@ -16,6 +16,7 @@ class LocationBlock {
     std::string path;                                  // URL path this location matches
     bool exact_match;                                  // Whether this is an exact path match (=)
     std::vector<HttpMethods::Method> allowed_methods;  // GET, POST, DELETE, etc.
+    unsigned int allowed_method_mask;                  // Bit (1 << method) per allowed method
     std::string root;                                  // Root directory for this location
     std::string index;                                 // Default file
     bool autoindex;                                    // Directory listing enabled
@@ -35,7 +36,8 @@ class LocationBlock {
     // Validation methods - throws exceptions with descriptive error messages
     void is_valid() const;
 
-    // Method permission checking
+    // Method permission checking, on the mask compiled from allowed_methods
+    void compile_method_mask();
     bool is_allows_method(HttpMethods::Method method) const;
 
     // Returns a comma-separated string of allowed HTTP methods
@@ -0,0 +1,118 @@
+#include "LocationMatcher.hpp"
+
+#include <cstring>
+
+#include "LocationBlock.hpp"
+
+const int LocationMatcher::NO_MATCH;
+
+static const size_t NO_CHILD = static_cast<size_t>(-1);
+
+LocationMatcher::LocationMatcher() : nodes_(1) {
+}
+
+void LocationMatcher::build(const LocationBlockVector& locations) {
+    nodes_.assign(1, Node());
+    for (size_t i = 0; i < locations.size(); ++i) {
+        insert(locations[i].path, locations[i].exact_match, static_cast<int>(i));
+    }
+}
+
+// ------------------------------------------------------------------
+// Matching
+
+int LocationMatcher::match(const std::string& path) const {
+    int best = NO_MATCH;
+    size_t node = 0;
+    size_t pos = 0;
+
+    for (;;) {
+        const Node& current = nodes_[node];
+
+        // A prefix location applies up to a segment boundary: the path ends, a new segment
+        // starts, or the location itself ends with a slash
+        if (current.prefix != NO_MATCH &&
+            (pos == path.size() || path[pos] == '/' || (pos > 0 && path[pos - 1] == '/'))) {
+            best = current.prefix;
+        }
+        if (pos == path.size()) {
+            return current.exact != NO_MATCH ? current.exact : best;
+        }
+
+        size_t child = find_child(node, path[pos]);
+        if (child == NO_CHILD) {
+            return best;
+        }
+        const std::string& label = nodes_[child].label;
+        if (path.compare(pos, label.size(), label) != 0) {
+            return best;
+        }
+        pos += label.size();
+        node = child;
+    }
+}
+
+// ------------------------------------------------------------------
+// Construction
+
+void LocationMatcher::insert(const std::string& path, bool exact_match, int index) {
+    size_t node = 0;
+    size_t pos = 0;
+
+    while (pos < path.size()) {
+        size_t child = find_child(node, path[pos]);
+        if (child == NO_CHILD) {
+            node = add_child(node, path.substr(pos));
+            break;
+        }
+
+        // Follow the edge as far as it agrees with the path
+        const std::string& label = nodes_[child].label;
+        size_t common = 1;
+        while (common < label.size() && pos + common < path.size() &&
+               label[common] == path[pos + common]) {
+            common++;
+        }
+        if (common < label.size()) {
+            // Split the edge: a new node takes the common part, the child keeps the rest
+            size_t middle = add_child(node, label.substr(0, common));
+            nodes_[middle].child_bytes = nodes_[child].label[common];
+            nodes_[middle].children.push_back(child);
+            nodes_[child].label.erase(0, common);
+            child = middle;
+        }
+        pos += common;
+        node = child;
+    }
+
+    int& slot = exact_match ? nodes_[node].exact : nodes_[node].prefix;
+    if (slot == NO_MATCH) {
+        slot = index;
+    }
+}
+
+size_t LocationMatcher::find_child(size_t node, char byte) const {
+    const Node& current = nodes_[node];
+    const void* found = std::memchr(current.child_bytes.data(), byte, current.child_bytes.size());
+    if (!found) {
+        return NO_CHILD;
+    }
+    return current.children[static_cast<const char*>(found) - current.child_bytes.data()];
+}
+
+// Add a child under node, or put it in place of the child starting with the same byte
+size_t LocationMatcher::add_child(size_t node, const std::string& label) {
+    size_t child = nodes_.size();
+    nodes_.push_back(Node());
+    nodes_[child].label = label;
+
+    Node& parent = nodes_[node];
+    size_t slot = parent.child_bytes.find(label[0]);
+    if (slot == std::string::npos) {
+        parent.child_bytes += label[0];
+        parent.children.push_back(child);
+    } else {
+        parent.children[slot] = child;
+    }
+    return child;
+}
@@ -0,0 +1,55 @@
+#ifndef LOCATION_MATCHER_HPP
+#define LOCATION_MATCHER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../../utils/Types.hpp"
+
+/**
+ * Radix trie over the location paths of a server block, compiled once the configuration is
+ * loaded (ServerBlock::compile_locations).
+ *
+ * Each node holds the label of the edge leading to it and the locations whose path ends
+ * there: at most one exact location ("location = /path") and one prefix location. A match
+ * walks the request path down the trie once, so it costs O(path length) whatever the number
+ * of locations. Along the way it keeps the deepest prefix location that ends on a segment
+ * boundary: "/upload" matches "/upload" and "/upload/a", not "/uploads". An exact location
+ * reached at the end of the path wins over any prefix one.
+ *
+ * Locations are referred to by their index in the server block, so the matcher stays valid
+ * when the server block is copied.
+ */
+class LocationMatcher {
+   public:
+    static const int NO_MATCH = -1;
+
+    LocationMatcher();
+
+    // Compile the trie from the locations, the first of two identical locations wins
+    void build(const LocationBlockVector& locations);
+
+    // Index of the location for a normalized path, NO_MATCH when none matches
+    int match(const std::string& path) const;
+
+   private:
+    struct Node {
+        std::string label;             // Bytes on the edge from the parent, empty at the root
+        std::string child_bytes;       // First label byte of each child, in children order
+        std::vector<size_t> children;  // Node indices
+        int exact;                     // "location = path" ending here, or NO_MATCH
+        int prefix;                    // "location path" ending here, or NO_MATCH
+
+        Node() : exact(NO_MATCH), prefix(NO_MATCH) {
+        }
+    };
+
+    std::vector<Node> nodes_;  // nodes_[0] is the root
+
+    void insert(const std::string& path, bool exact_match, int index);
+    size_t find_child(size_t node, char byte) const;
+    size_t add_child(size_t node, const std::string& label);
+};
+
+#endif  // LOCATION_MATCHER_HPP
@@ -29,43 +29,20 @@ void ServerBlock::is_valid() const {
     validate_root();
 }
 
-const LocationBlock* ServerBlock::match_location(const std::string& uri) const {
-    // First, try to find an exact match
-    for (LocationBlockVectorConstIt it = locations.begin(); it != locations.end(); ++it) {
-        if (it->exact_match && uri == it->path) {
-            return &(*it);
-        }
-    }
-
-    // If no exact match, fall back to the longest matching prefix
-    size_t longest_match = 0;
-    const LocationBlock* matched_location = NULL;
-
-    for (LocationBlockVectorConstIt it = locations.begin(); it != locations.end(); ++it) {
-        // Skip exact match locations, as we already checked them
-        if (it->exact_match) {
-            continue;
-        }
-
-        // Check if this location's path is a prefix of the URI
-        if (uri.find(it->path) == 0 && it->path.length() > longest_match) {
-            longest_match = it->path.length();
-            matched_location = &(*it);
-        }
+void ServerBlock::compile_locations() {
+    for (LocationBlockVectorIt it = locations.begin(); it != locations.end(); ++it) {
+        it->compile_method_mask();
     }
-
-    return matched_location;
+    location_matcher_.build(locations);
 }
 
-bool ServerBlock::matches_server_name(const std::string& host) const {
-    const std::string normalized_host = normalize_server_name(host);
-
-    for (StringVectorConstIt it = server_names.begin(); it != server_names.end(); ++it) {
-        if (normalize_server_name(*it) == normalized_host) {
-            return true;
-        }
+// Exact match first, then the longest prefix ending on a segment boundary
+const LocationBlock* ServerBlock::match_location(const std::string& uri) const {
+    int index = location_matcher_.match(uri);
+    if (index == LocationMatcher::NO_MATCH) {
+        return NULL;
     }
-    return false;
+    return &locations[index];
 }
 
 void ServerBlock::validate_listen_directives() const {
@@ -8,6 +8,7 @@
 
 #include "../../utils/Types.hpp"
 #include "LocationBlock.hpp"
+#include "LocationMatcher.hpp"
 
 class ServerBlock {
    public:
@@ -33,12 +34,16 @@ class ServerBlock {
     // Validation methods - throws exceptions with descriptive error messages
     void is_valid() const;
 
+    // Compile the location matcher and the method masks, once the locations are final
+    void compile_locations();
+
     // Utility methods
     const LocationBlock* match_location(const std::string& uri) const;
-    bool matches_server_name(const std::string& host) const;
     std::string normalize_server_name(const std::string& name) const;
 
    private:
+    LocationMatcher location_matcher_;  // Built by compile_locations()
+
     // Helper methods for validation that throw exceptions with descriptive messages
     void validate_listen_directives() const;
     void validate_locations() const;
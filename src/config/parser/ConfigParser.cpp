@@ -16,6 +16,7 @@ std::vector<ServerBlock> ConfigParser::parse(const std::string& filename) {
     tokens_ = tokenizer.tokenize(filename);
     current_token_ = 0;
     server_blocks_.clear();
+    global_block_ = GlobalBlock();
     current_filename_ = filename;  // Store the filename for error messages
 
     // check if the file is empty
@@ -27,14 +28,26 @@ std::vector<ServerBlock> ConfigParser::parse(const std::string& filename) {
            tokens_[current_token_].type != ConfigToken::END_OF_FILE) {
         if (match_token(ConfigToken::IDENTIFIER, "server")) {
             parse_server_block();
+        } else if (check_token(ConfigToken::IDENTIFIER)) {
+            parse_global_directive();
         } else {
             syntax_error("Expected 'server' block", get_current_token());
         }
     }
 
+    try {
+        global_block_.is_valid();
+    } catch (const std::exception& e) {
+        syntax_error("Invalid global configuration: " + std::string(e.what()), get_last_token());
+    }
+
     return server_blocks_;
 }
 
+const GlobalBlock& ConfigParser::get_global_block() const {
+    return global_block_;
+}
+
 void ConfigParser::syntax_error(const std::string& message, const ConfigToken& token) {
     std::string filename = current_filename_;
 
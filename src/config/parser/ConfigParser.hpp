@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "../../utils/Types.hpp"
+#include "../contexts/GlobalBlock.hpp"
 #include "../contexts/ServerBlock.hpp"
 #include "../tokenizer/ConfigTokenizer.hpp"
 
@@ -20,13 +21,22 @@ class ConfigParser {
     // Parse a configuration file into server blocks
     ServerBlockVector parse(const std::string& filename);
 
+    // Main-context directives collected by the last parse()
+    const GlobalBlock& get_global_block() const;
+
    private:
     // Parsing methods
+    void parse_global_directive();
     void parse_server_block();
     void parse_location_block(ServerBlock& server);
     void parse_directive(ServerBlock& server, LocationBlock* location = NULL);
 
+    // Read a directive name and its values up to the terminating semicolon
+    ConfigToken read_directive(DirectiveValues& values);
+
     // Process a directive based on its name and context
+    void process_global_directive(
+        const std::string& name, const DirectiveValues& values, const ConfigToken& directive_token);
     void process_directive(
         const std::string& name, const DirectiveValues& values, const ConfigToken& directive_token,
         ServerBlock& server, LocationBlock* location = NULL);
@@ -62,6 +72,14 @@ class ConfigParser {
     void parse_methods_directive(
         LocationBlock& location, const DirectiveValues& values, const ConfigToken& directive_token);
 
+    bool parse_flag(const std::string& value, const ConfigToken& directive_token);
+    int parse_positive_number(const std::string& value, const ConfigToken& directive_token);
+    int parse_count_or_auto(
+        const std::string& value, int limit, const ConfigToken& directive_token);
+    size_t parse_size(
+        const std::string& size_str, const std::string& directive_name,
+        const ConfigToken& directive_token);
+
     // Validation helpers
     void expect_single_value(
         const DirectiveValues& values, const std::string& directive_name,
@@ -74,6 +92,7 @@ class ConfigParser {
     std::vector<ConfigToken> tokens_;  // Tokens from the tokenizer
     size_t current_token_;             // Index of current token
     ServerBlockVector server_blocks_;  // Output server blocks
+    GlobalBlock global_block_;         // Output main-context directives
     std::string current_filename_;     // Current file being parsed
 };
 
@@ -20,15 +20,20 @@ static const int REDIRECT_TEMPORARY_REDIRECT = 307;
 static const int REDIRECT_PERMANENT_REDIRECT = 308;
 
 void ConfigParser::parse_directive(ServerBlock& server, LocationBlock* location) {
+    std::vector<std::string> values;
+    ConfigToken directive = read_directive(values);
+
+    // Process directive based on context and name
+    process_directive(directive.value, values, directive, server, location);
+}
+
+ConfigToken ConfigParser::read_directive(std::vector<std::string>& values) {
     // Get directive name token
     ConfigToken directive = consume_token_with_check("Expected directive");
     if (directive.type != ConfigToken::IDENTIFIER) {
         syntax_error("Expected directive name", directive);
     }
 
-    std::string name = directive.value;
-    std::vector<std::string> values;
-
     // Parse directive values until semicolon
     while (!check_token(ConfigToken::SEMICOLON)) {
         ConfigToken value = consume_token_with_check("Unexpected end of directive");
@@ -42,8 +47,7 @@ void ConfigParser::parse_directive(ServerBlock& server, LocationBlock* location)
     // Consume the semicolon
     expect_token_with_error(ConfigToken::SEMICOLON, "Expected ';' after directive");
 
-    // Process directive based on context and name
-    process_directive(name, values, directive, server, location);
+    return directive;
 }
 
 void ConfigParser::process_directive(
@@ -183,6 +187,17 @@ void ConfigParser::parse_server_name_directive(
         if (it->empty()) {
             syntax_error("server_name values cannot be empty", directive_token);
         }
+
+        // A wildcard is a whole first or last label: "*.example.com" or "www.example.*"
+        size_t star = it->find('*');
+        if (star != std::string::npos) {
+            size_t last = it->size() - 1;
+            bool leading = star == 0 && it->size() > 2 && (*it)[1] == '.';
+            bool trailing = star == last && it->size() > 2 && (*it)[last - 1] == '.';
+            if ((!leading && !trailing) || it->find('*', star + 1) != std::string::npos) {
+                syntax_error("Invalid wildcard server_name: " + *it, directive_token);
+            }
+        }
     }
 
     server.server_names = values;
@@ -193,8 +208,13 @@ void ConfigParser::parse_client_max_body_size_directive(
     const ConfigToken& directive_token) {
     expect_single_value(values, "client_max_body_size", directive_token);
 
-    std::string size_str = values[0];
+    max_size = parse_size(values[0], "client_max_body_size", directive_token);
+    max_size_set = true;
+}
 
+size_t ConfigParser::parse_size(
+    const std::string& size_str, const std::string& directive_name,
+    const ConfigToken& directive_token) {
     // Limit to MAX_SIZE_DIGITS digits (up to 1GB in bytes)
     size_t digit_count = 0;
     size_t i = 0;
@@ -203,7 +223,7 @@ void ConfigParser::parse_client_max_body_size_directive(
         i++;
     }
     if (digit_count > MAX_SIZE_DIGITS) {
-        syntax_error("client_max_body_size value too large (max 1GB allowed)", directive_token);
+        syntax_error(directive_name + " value too large (max 1GB allowed)", directive_token);
     }
 
     // Parse the numeric part
@@ -218,14 +238,11 @@ void ConfigParser::parse_client_max_body_size_directive(
 
         // Maximum reasonable values for each unit for a school project
         if (unit == 'k' && size_value > MAX_SIZE_VALUE_KB) {  // Max 1GB in KB
-            syntax_error(
-                "client_max_body_size exceeds maximum allowed size (1GB)", directive_token);
+            syntax_error(directive_name + " exceeds maximum allowed size (1GB)", directive_token);
         } else if (unit == 'm' && size_value > MAX_SIZE_VALUE_MB) {  // Max 1GB in MB
-            syntax_error(
-                "client_max_body_size exceeds maximum allowed size (1GB)", directive_token);
+            syntax_error(directive_name + " exceeds maximum allowed size (1GB)", directive_token);
         } else if (unit == 'g' && size_value > MAX_SIZE_VALUE_GB) {  // Max 1GB in GB
-            syntax_error(
-                "client_max_body_size exceeds maximum allowed size (1GB)", directive_token);
+            syntax_error(directive_name + " exceeds maximum allowed size (1GB)", directive_token);
         } else if (unit != 'k' && unit != 'm' && unit != 'g') {
             syntax_error("Invalid size unit: " + std::string(1, unit), directive_token);
         }
@@ -239,6 +256,5 @@ void ConfigParser::parse_client_max_body_size_directive(
             size_value *= GIGABYTE_MULTIPLIER;
     }
 
-    max_size = size_value;
-    max_size_set = true;
+    return size_value;
 }
@@ -0,0 +1,118 @@
+// src/config/parser/ParserGlobalDirectives.cpp
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "ConfigParser.hpp"
+
+void ConfigParser::parse_global_directive() {
+    DirectiveValues values;
+    ConfigToken directive = read_directive(values);
+
+    process_global_directive(directive.value, values, directive);
+}
+
+void ConfigParser::process_global_directive(
+    const std::string& name, const DirectiveValues& values, const ConfigToken& directive_token) {
+    if (name == "event_backend") {
+        expect_single_value(values, "event_backend", directive_token);
+        std::string backend = values[0];
+        std::transform(backend.begin(), backend.end(), backend.begin(), ::tolower);
+        if (backend != "epoll" && backend != "poll" && backend != "io_uring") {
+            syntax_error("Invalid event_backend: " + values[0], directive_token);
+        }
+        global_block_.event_backend = backend;
+    } else if (name == "edge_triggered") {
+        expect_single_value(values, "edge_triggered", directive_token);
+        global_block_.edge_triggered = parse_flag(values[0], directive_token);
+    } else if (name == "worker_processes") {
+        expect_single_value(values, "worker_processes", directive_token);
+        global_block_.worker_processes =
+            parse_count_or_auto(values[0], GlobalBlock::MAX_WORKER_PROCESSES, directive_token);
+    } else if (name == "worker_cpu_affinity") {
+        expect_single_value(values, "worker_cpu_affinity", directive_token);
+        global_block_.worker_cpu_affinity = parse_flag(values[0], directive_token);
+    } else if (name == "reactor_threads") {
+        expect_single_value(values, "reactor_threads", directive_token);
+        global_block_.reactor_threads =
+            parse_count_or_auto(values[0], GlobalBlock::MAX_REACTOR_THREADS, directive_token);
+    } else if (name == "reactor_balance") {
+        expect_single_value(values, "reactor_balance", directive_token);
+        if (values[0] != "round_robin" && values[0] != "least_loaded") {
+            syntax_error("Invalid reactor_balance: " + values[0], directive_token);
+        }
+        global_block_.reactor_balance = values[0];
+    } else if (name == "max_connections") {
+        expect_single_value(values, "max_connections", directive_token);
+        global_block_.max_connections = parse_positive_number(values[0], directive_token);
+    } else if (name == "accept_batch") {
+        expect_single_value(values, "accept_batch", directive_token);
+        global_block_.accept_batch = parse_positive_number(values[0], directive_token);
+    } else if (name == "client_header_buffer_size") {
+        expect_single_value(values, "client_header_buffer_size", directive_token);
+        global_block_.client_header_buffer_size =
+            parse_size(values[0], "client_header_buffer_size", directive_token);
+    } else if (name == "client_header_max_size") {
+        expect_single_value(values, "client_header_max_size", directive_token);
+        global_block_.client_header_max_size =
+            parse_size(values[0], "client_header_max_size", directive_token);
+    } else if (name == "client_body_buffer_size") {
+        expect_single_value(values, "client_body_buffer_size", directive_token);
+        global_block_.client_body_buffer_size =
+            parse_size(values[0], "client_body_buffer_size", directive_token);
+    } else if (name == "client_body_temp_path") {
+        expect_single_value(values, "client_body_temp_path", directive_token);
+        global_block_.client_body_temp_path = values[0];
+    } else {
+        syntax_error("Unknown global directive: " + name, directive_token);
+    }
+}
+
+bool ConfigParser::parse_flag(const std::string& value, const ConfigToken& directive_token) {
+    std::string flag = value;
+    std::transform(flag.begin(), flag.end(), flag.begin(), ::tolower);
+
+    if (flag == "on" || flag == "true" || flag == "1") {
+        return true;
+    }
+    if (flag == "off" || flag == "false" || flag == "0") {
+        return false;
+    }
+    syntax_error("Invalid flag value: " + value + " (expected on or off)", directive_token);
+    return false;
+}
+
+int ConfigParser::parse_count_or_auto(
+    const std::string& value, int limit, const ConfigToken& directive_token) {
+    if (value != "auto") {
+        return parse_positive_number(value, directive_token);
+    }
+
+    // One per online CPU
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) {
+        return 1;
+    }
+    return cpus > limit ? limit : static_cast<int>(cpus);
+}
+
+int ConfigParser::parse_positive_number(
+    const std::string& value, const ConfigToken& directive_token) {
+    // Must contain only digits, and few enough of them to fit an int
+    if (value.empty() || value.length() > 9) {
+        syntax_error("Invalid number: " + value, directive_token);
+    }
+    for (size_t i = 0; i < value.length(); ++i) {
+        if (!std::isdigit(value[i])) {
+            syntax_error("Invalid number: " + value, directive_token);
+        }
+    }
+
+    int number = std::atoi(value.c_str());
+    if (number <= 0) {
+        syntax_error("Value must be greater than zero: " + value, directive_token);
+    }
+    return number;
+}
@@ -194,15 +194,17 @@ bool ConfigTokenizer::is_whitespace(char c) {
 
 bool ConfigTokenizer::is_identifier_start(char c) {
     // Allow forward slash and dots as valid starting characters for paths and extensions
-    // Also allow letters for scheme-based URLs (http, https, etc.)
-    return std::isalpha(c) || c == '_' || c == '/' || c == '.';
+    // Also allow letters for scheme-based URLs (http, https, etc.), and '*' for wildcard
+    // server names ("*.example.com")
+    return std::isalpha(c) || c == '_' || c == '/' || c == '.' || c == '*';
 }
 
 bool ConfigTokenizer::is_identifier_part(char c) {
     // Allow standard identifier characters plus URL characters
-    // This includes query parameters (?key=value&key2=value2) and schemes (http://, https:// )
+    // This includes query parameters (?key=value&key2=value2) and schemes (http://, https:// ),
+    // and '*' for wildcard server names ("www.example.*")
     return std::isalnum(c) || c == '_' || c == '-' || c == '.' || c == '/' || c == ':' ||
-           c == '?' || c == '&' || c == '=' || c == '#' || c == '%';
+           c == '?' || c == '&' || c == '=' || c == '#' || c == '%' || c == '*';
 }
 
 void ConfigTokenizer::syntax_error(const std::string& message) {
@@ -0,0 +1,294 @@
+#include "CharScan.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHAR_SCAN_X86
+#include <immintrin.h>
+#endif
+
+// Class bits of the table below
+static const unsigned char NONE = 0;
+static const unsigned char V = 1 << CharScan::FIELD_VALUE;
+static const unsigned char TV = V | (1 << CharScan::TOKEN);
+static const unsigned char VU = V | (1 << CharScan::URI_CHAR);
+static const unsigned char TVU = TV | VU;
+
+// Shuffle tables of a class: a byte is a member when low[b & 0xF] & high[b >> 4] != 0. Each
+// high nibble row of CLASS_TABLE gets a bit (rows with the same members share it), low holds
+// for each low nibble the bits of the rows it is a member of.
+struct NibbleTables {
+    unsigned char low[16];
+    unsigned char high[16];
+};
+
+static NibbleTables nibble_tables[CharScan::CLASS_COUNT];
+static CharScan::Kernel best_kernel = CharScan::SCALAR;
+
+namespace CharScan {
+    // clang-format off
+    const unsigned char CLASS_TABLE[256] = {
+        NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE, // 00 01 02 03 04 05 06 07
+        NONE, V,    NONE, NONE, NONE, NONE, NONE, NONE, // 08 09 0A 0B 0C 0D 0E 0F
+        NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE, // 10 11 12 13 14 15 16 17
+        NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE, // 18 19 1A 1B 1C 1D 1E 1F
+        V,    TVU,  V,    TVU,  TVU,  TV,   TVU,  TVU,  // SP ! " # $ % & '
+        VU,   VU,   TVU,  TVU,  VU,   TVU,  TVU,  VU,   // ( ) * + , - . /
+        TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // 0 1 2 3 4 5 6 7
+        TVU,  TVU,  VU,   VU,   V,    VU,   V,    VU,   // 8 9 : ; < = > ?
+        VU,   TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // @ A B C D E F G
+        TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // H I J K L M N O
+        TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // P Q R S T U V W
+        TVU,  TVU,  TVU,  V,    V,    V,    TV,   TVU,  // X Y Z [ \ ] ^ _
+        TV,   TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // ` a b c d e f g
+        TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // h i j k l m n o
+        TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  TVU,  // p q r s t u v w
+        TVU,  TVU,  TVU,  V,    TV,   V,    TVU,  NONE, // x y z { | } ~ 7F
+        V,    V,    V,    V,    V,    V,    V,    V,    // 80 81 82 83 84 85 86 87
+        V,    V,    V,    V,    V,    V,    V,    V,    // 88 89 8A 8B 8C 8D 8E 8F
+        V,    V,    V,    V,    V,    V,    V,    V,    // 90 91 92 93 94 95 96 97
+        V,    V,    V,    V,    V,    V,    V,    V,    // 98 99 9A 9B 9C 9D 9E 9F
+        V,    V,    V,    V,    V,    V,    V,    V,    // A0 A1 A2 A3 A4 A5 A6 A7
+        V,    V,    V,    V,    V,    V,    V,    V,    // A8 A9 AA AB AC AD AE AF
+        V,    V,    V,    V,    V,    V,    V,    V,    // B0 B1 B2 B3 B4 B5 B6 B7
+        V,    V,    V,    V,    V,    V,    V,    V,    // B8 B9 BA BB BC BD BE BF
+        V,    V,    V,    V,    V,    V,    V,    V,    // C0 C1 C2 C3 C4 C5 C6 C7
+        V,    V,    V,    V,    V,    V,    V,    V,    // C8 C9 CA CB CC CD CE CF
+        V,    V,    V,    V,    V,    V,    V,    V,    // D0 D1 D2 D3 D4 D5 D6 D7
+        V,    V,    V,    V,    V,    V,    V,    V,    // D8 D9 DA DB DC DD DE DF
+        V,    V,    V,    V,    V,    V,    V,    V,    // E0 E1 E2 E3 E4 E5 E6 E7
+        V,    V,    V,    V,    V,    V,    V,    V,    // E8 E9 EA EB EC ED EE EF
+        V,    V,    V,    V,    V,    V,    V,    V,    // F0 F1 F2 F3 F4 F5 F6 F7
+        V,    V,    V,    V,    V,    V,    V,    V,    // F8 F9 FA FB FC FD FE FF
+    };
+    // clang-format on
+}  // namespace CharScan
+
+// ----------------------------------------------------------------------------
+// Scalar kernels
+// ----------------------------------------------------------------------------
+
+static size_t span_scalar(const char* data, size_t length, CharScan::CharClass char_class) {
+    size_t i = 0;
+    while (i < length && CharScan::is_in_class(data[i], char_class)) {
+        i++;
+    }
+    return i;
+}
+
+static const char* find_line_end_scalar(const char* data, size_t length) {
+    return static_cast<const char*>(std::memchr(data, '\n', length));
+}
+
+// ----------------------------------------------------------------------------
+// Vector kernels
+// ----------------------------------------------------------------------------
+
+#ifdef CHAR_SCAN_X86
+
+__attribute__((target("sse4.2"))) static size_t span_sse42(
+    const char* data, size_t length, CharScan::CharClass char_class) {
+    const NibbleTables& tables = nibble_tables[char_class];
+    const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.low));
+    const __m128i high_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.high));
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(bytes, nibble_mask));
+        __m128i high =
+            _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask));
+        __m128i outside = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+        int mask = _mm_movemask_epi8(outside);
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + span_scalar(data + i, length - i, char_class);
+}
+
+__attribute__((target("sse4.2"))) static const char* find_line_end_sse42(
+    const char* data, size_t length) {
+    const __m128i line_feed = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, line_feed));
+        if (mask) {
+            return data + i + __builtin_ctz(mask);
+        }
+    }
+    return find_line_end_scalar(data + i, length - i);
+}
+
+__attribute__((target("avx2"))) static size_t span_avx2(
+    const char* data, size_t length, CharScan::CharClass char_class) {
+    const NibbleTables& tables = nibble_tables[char_class];
+    const __m256i low_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.low)));
+    const __m256i high_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.high)));
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(bytes, nibble_mask));
+        __m256i high = _mm256_shuffle_epi8(
+            high_table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask));
+        __m256i outside = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(outside));
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    // Tail 16 bytes at a time, VEX encoded here (calling the SSE kernel would mix encodings)
+    const __m128i low_half = _mm256_castsi256_si128(low_table);
+    const __m128i high_half = _mm256_castsi256_si128(high_table);
+    const __m128i half_mask = _mm256_castsi256_si128(nibble_mask);
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i low = _mm_shuffle_epi8(low_half, _mm_and_si128(bytes, half_mask));
+        __m128i high =
+            _mm_shuffle_epi8(high_half, _mm_and_si128(_mm_srli_epi16(bytes, 4), half_mask));
+        __m128i outside = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+        int mask = _mm_movemask_epi8(outside);
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + span_scalar(data + i, length - i, char_class);
+}
+
+__attribute__((target("avx2"))) static const char* find_line_end_avx2(
+    const char* data, size_t length) {
+    const __m256i line_feed = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i matches = _mm256_cmpeq_epi8(bytes, line_feed);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+        if (mask) {
+            return data + i + __builtin_ctz(mask);
+        }
+    }
+    if (i + 16 <= length) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(line_feed)));
+        if (mask) {
+            return data + i + __builtin_ctz(mask);
+        }
+        i += 16;
+    }
+    return find_line_end_scalar(data + i, length - i);
+}
+
+#endif  // CHAR_SCAN_X86
+
+// ----------------------------------------------------------------------------
+// Kernel selection
+// ----------------------------------------------------------------------------
+
+static void build_nibble_tables(CharScan::CharClass char_class, NibbleTables& tables) {
+    std::memset(&tables, 0, sizeof(tables));
+    unsigned short row_members[16];
+    int next_bit = 0;
+
+    for (int high = 0; high < 16; ++high) {
+        row_members[high] = 0;
+        for (int low = 0; low < 16; ++low) {
+            if (CharScan::is_in_class(static_cast<char>(high << 4 | low), char_class)) {
+                row_members[high] |= 1 << low;
+            }
+        }
+        if (row_members[high] == 0) {
+            continue;  // No member in this row, high stays 0
+        }
+
+        // Share the bit of an identical row, the classes have at most 8 distinct rows
+        for (int previous = 0; previous < high && !tables.high[high]; ++previous) {
+            if (row_members[previous] == row_members[high]) {
+                tables.high[high] = tables.high[previous];
+            }
+        }
+        if (!tables.high[high]) {
+            tables.high[high] = static_cast<unsigned char>(1 << next_bit++);
+        }
+        for (int low = 0; low < 16; ++low) {
+            if (row_members[high] & (1 << low)) {
+                tables.low[low] |= tables.high[high];
+            }
+        }
+    }
+}
+
+static CharScan::Kernel detect_kernel() {
+    for (int char_class = 0; char_class < CharScan::CLASS_COUNT; ++char_class) {
+        CharScan::CharClass current = static_cast<CharScan::CharClass>(char_class);
+        build_nibble_tables(current, nibble_tables[char_class]);
+    }
+#ifdef CHAR_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        best_kernel = CharScan::AVX2;
+    } else if (__builtin_cpu_supports("sse4.2")) {
+        best_kernel = CharScan::SSE42;
+    }
+#endif
+    return best_kernel;
+}
+
+static CharScan::Kernel active_kernel = detect_kernel();
+
+namespace CharScan {
+    // Runs shorter than an AVX2 block (most header names and values) take the SSE kernel
+    size_t span(const char* data, size_t length, CharClass char_class) {
+#ifdef CHAR_SCAN_X86
+        if (active_kernel == AVX2 && length >= 32) {
+            return span_avx2(data, length, char_class);
+        }
+        if (active_kernel >= SSE42) {
+            return span_sse42(data, length, char_class);
+        }
+#endif
+        return span_scalar(data, length, char_class);
+    }
+
+    const char* find_line_end(const char* data, size_t length) {
+#ifdef CHAR_SCAN_X86
+        if (active_kernel == AVX2 && length >= 32) {
+            return find_line_end_avx2(data, length);
+        }
+        if (active_kernel >= SSE42) {
+            return find_line_end_sse42(data, length);
+        }
+#endif
+        return find_line_end_scalar(data, length);
+    }
+
+    Kernel get_kernel() {
+        return active_kernel;
+    }
+
+    const char* get_kernel_name(Kernel kernel) {
+        switch (kernel) {
+            case AVX2:
+                return "avx2";
+            case SSE42:
+                return "sse4.2";
+            default:
+                return "scalar";
+        }
+    }
+
+    bool set_kernel(Kernel kernel) {
+        if (kernel > best_kernel) {
+            return false;
+        }
+        active_kernel = kernel;
+        return true;
+    }
+}  // namespace CharScan
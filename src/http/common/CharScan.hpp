@@ -0,0 +1,42 @@
+#ifndef CHAR_SCAN_HPP
+#define CHAR_SCAN_HPP
+
+#include <cstddef>
+
+/**
+ * Byte scanning kernels for the request parser: line ends and RFC 7230 character classes.
+ *
+ * Every class is a bit of one 256-entry table, which is what the scalar kernel reads. The
+ * vector kernels (SSE4.2, AVX2 on x86) classify 16 or 32 bytes at once with two 16-entry
+ * shuffle tables derived from it, one indexed by the low nibble of each byte and one by the
+ * high nibble. The fastest kernel the CPU supports is chosen once at startup.
+ */
+namespace CharScan {
+    enum CharClass {
+        TOKEN = 0,    // tchar (RFC 7230, Section 3.2.6), header field names and methods
+        FIELD_VALUE,  // VCHAR, SP, HTAB and obs-text (RFC 7230, Section 3.2)
+        URI_CHAR,     // Request-target characters allowed unencoded, '%' excluded
+        CLASS_COUNT
+    };
+
+    enum Kernel { SCALAR = 0, SSE42, AVX2 };
+
+    extern const unsigned char CLASS_TABLE[256];  // Bit (1 << class) set for members
+
+    inline bool is_in_class(char c, CharClass char_class) {
+        return (CLASS_TABLE[static_cast<unsigned char>(c)] >> char_class) & 1;
+    }
+
+    // Index of the first byte not in the class, length when they all are
+    size_t span(const char* data, size_t length, CharClass char_class);
+
+    // First LF of data, NULL when there is none
+    const char* find_line_end(const char* data, size_t length);
+
+    // Kernel in use, and a switch for benchmarks (false if the CPU lacks it)
+    Kernel get_kernel();
+    const char* get_kernel_name(Kernel kernel);
+    bool set_kernel(Kernel kernel);
+}  // namespace CharScan
+
+#endif  // CHAR_SCAN_HPP
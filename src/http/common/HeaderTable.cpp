@@ -0,0 +1,133 @@
+#include "HeaderTable.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Headers.hpp"
+
+const size_t HeaderTable::MAX_FIELDS;
+
+HeaderTable::HeaderTable() : count_(0) {
+    std::fill(known_, known_ + HttpHeaders::KNOWN_COUNT, MAX_FIELDS);
+}
+
+void HeaderTable::clear() {
+    bytes_.clear();  // Capacity is kept for the next request
+    count_ = 0;
+    std::fill(known_, known_ + HttpHeaders::KNOWN_COUNT, MAX_FIELDS);
+}
+
+HeaderTable::AddResult HeaderTable::add(
+    const char* name, size_t name_length, const char* value, size_t value_length) {
+    HttpHeaders::Known known = HttpHeaders::classify(name, name_length);
+    bool is_list = HttpHeaders::is_combinable_header(name, name_length) ||
+                   HttpHeaders::is_special_multiple_header(name, name_length);
+    size_t existing =
+        known != HttpHeaders::UNKNOWN_HEADER ? find(known) : scan(name, name_length, 0);
+
+    if (existing < count_ && !is_list) {
+        if (known == HttpHeaders::KNOWN_HOST) {
+            return CONFLICTING_DUPLICATE;
+        }
+        if (known == HttpHeaders::KNOWN_CONTENT_LENGTH) {
+            Slice first = value_at(existing);
+            bool same = first.length == value_length &&
+                        std::memcmp(first.data, value, value_length) == 0;
+            return same ? ADDED : CONFLICTING_DUPLICATE;
+        }
+
+        // Single-value header seen again: the last value wins, the old bytes stay unused
+        fields_[existing].value_offset = bytes_.length();
+        fields_[existing].value_length = value_length;
+        bytes_.append(value, value_length);
+        return ADDED;
+    }
+    if (count_ == MAX_FIELDS) {
+        return TABLE_FULL;
+    }
+    if (existing < count_) {
+        fields_[existing].repeated = true;
+    }
+
+    if (known != HttpHeaders::UNKNOWN_HEADER && known_[known] == MAX_FIELDS) {
+        known_[known] = count_;
+    }
+    Field& field = fields_[count_++];
+    field.name_offset = bytes_.length();
+    field.name_length = name_length;
+    bytes_.append(name, name_length);
+    field.value_offset = bytes_.length();
+    field.value_length = value_length;
+    field.repeated = false;
+    bytes_.append(value, value_length);
+    return ADDED;
+}
+
+HeaderTable::Slice HeaderTable::name_at(size_t index) const {
+    Slice slice = {bytes_.data() + fields_[index].name_offset, fields_[index].name_length};
+    return slice;
+}
+
+HeaderTable::Slice HeaderTable::value_at(size_t index) const {
+    Slice slice = {bytes_.data() + fields_[index].value_offset, fields_[index].value_length};
+    return slice;
+}
+
+size_t HeaderTable::find(const char* name, size_t from) const {
+    return find(name, std::strlen(name), from);
+}
+
+size_t HeaderTable::find(const char* name, size_t name_length, size_t from) const {
+    // A known name's first field is in its slot, later ones are only there for list headers
+    HttpHeaders::Known known = HttpHeaders::classify(name, name_length);
+    if (known != HttpHeaders::UNKNOWN_HEADER) {
+        size_t first = find(known);
+        if (from == 0 || first == count_) {
+            return first;
+        }
+        from = std::max(from, first + 1);
+    }
+    return scan(name, name_length, from);
+}
+
+size_t HeaderTable::scan(const char* name, size_t name_length, size_t from) const {
+    const char* bytes = bytes_.data();
+    for (size_t i = from; i < count_; ++i) {
+        const Field& field = fields_[i];
+        if (field.name_length != name_length) {
+            continue;
+        }
+        const char* candidate = bytes + field.name_offset;
+        size_t j = 0;
+        while (j < name_length &&
+               HttpHeaders::to_lower_ascii(candidate[j]) == HttpHeaders::to_lower_ascii(name[j])) {
+            j++;
+        }
+        if (j == name_length) {
+            return i;
+        }
+    }
+    return count_;
+}
+
+bool HeaderTable::has(const char* name) const {
+    return find(name) < count_;
+}
+
+std::string HeaderTable::get(const char* name) const {
+    size_t name_length = std::strlen(name);
+    size_t index = find(name, name_length, 0);
+    if (index == count_) {
+        return "";
+    }
+
+    std::string value(bytes_.data() + fields_[index].value_offset, fields_[index].value_length);
+    if (!fields_[index].repeated) {
+        return value;
+    }
+    while ((index = find(name, name_length, index + 1)) < count_) {
+        const Field& field = fields_[index];
+        value.append(", ").append(bytes_.data() + field.value_offset, field.value_length);
+    }
+    return value;
+}
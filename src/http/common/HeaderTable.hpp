@@ -0,0 +1,91 @@
+#ifndef HEADER_TABLE_HPP
+#define HEADER_TABLE_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "Headers.hpp"
+
+/**
+ * Header fields of one request, as a flat table of (name, value) slices.
+ *
+ * Names and values are appended back to back to a single byte string and each field is
+ * four offsets into it, so storing a header is one append and no node or string of its
+ * own. The byte string keeps its capacity across clear(), which makes header storage
+ * allocation-free for every request after the first one on a connection. Lookups compare
+ * names case-insensitively in place.
+ *
+ * Names in HttpHeaders::Known are classified once, when the field is stored, and their
+ * first field is kept in a slot: finding Host or Content-Length is one array access.
+ *
+ * Duplicates follow RFC 7230, Section 3.2.2: list headers (HttpHeaders::is_combinable_header,
+ * Set-Cookie) keep one field per line and get() joins them with ", ", any other name keeps
+ * its last value only. Host and Content-Length decide where a request goes and where it
+ * ends, so a second Host or a second, different Content-Length is refused instead
+ * (Sections 5.4 and 3.3.2): two parsers picking different values is request smuggling.
+ */
+class HeaderTable {
+   public:
+    static const size_t MAX_FIELDS = 128;
+
+    enum AddResult {
+        ADDED,
+        TABLE_FULL,
+        CONFLICTING_DUPLICATE  // Second Host, or Content-Length with another value
+    };
+
+    // Bytes of a name or value in place, valid until the table changes
+    struct Slice {
+        const char* data;
+        size_t length;
+
+        std::string str() const {
+            return std::string(data, length);
+        }
+    };
+
+    HeaderTable();
+
+    void clear();
+
+    // Store a field
+    AddResult add(const char* name, size_t name_length, const char* value, size_t value_length);
+
+    size_t size() const {
+        return count_;
+    }
+    Slice name_at(size_t index) const;
+    Slice value_at(size_t index) const;
+
+    // Index of the first field of a known header, size() when there is none
+    size_t find(HttpHeaders::Known known) const {
+        return known_[known] < count_ ? known_[known] : count_;
+    }
+
+    // Index of the first field named name at or after from, size() when there is none
+    size_t find(const char* name, size_t from = 0) const;
+    size_t find(const char* name, size_t name_length, size_t from) const;
+    bool has(const char* name) const;
+
+    // Value of a field, duplicates joined with ", ", empty when absent
+    std::string get(const char* name) const;
+
+   private:
+    struct Field {
+        size_t name_offset;
+        size_t name_length;
+        size_t value_offset;
+        size_t value_length;
+        bool repeated;  // Later fields with the same name follow (list headers only)
+    };
+
+    std::string bytes_;                       // Names and values of every field, back to back
+    Field fields_[MAX_FIELDS];                // First count_ are in use
+    size_t count_;
+    size_t known_[HttpHeaders::KNOWN_COUNT];  // First field of each known header, or MAX_FIELDS
+
+    // Linear search by name, for unknown names and repeated list headers
+    size_t scan(const char* name, size_t name_length, size_t from) const;
+};
+
+#endif  // HEADER_TABLE_HPP
@@ -11,6 +11,7 @@ namespace HttpHeaders {
     const HeaderName CONTENT_LENGTH = "Content-Length";
     const HeaderName CONTENT_TYPE = "Content-Type";
     const HeaderName COOKIE = "Cookie";
+    const HeaderName EXPECT = "Expect";
     const HeaderName HOST = "Host";
     const HeaderName REFERER = "Referer";
     const HeaderName USER_AGENT = "User-Agent";
@@ -27,4 +28,35 @@ namespace HttpHeaders {
     const HeaderName SERVER = "Server";
     const HeaderName SET_COOKIE = "Set-Cookie";
     const HeaderName WWW_AUTHENTICATE = "WWW-Authenticate";
+
+    // Lowercase names of the Known ids, in enum order
+    static const char* const KNOWN_NAMES[KNOWN_COUNT] = {
+        "host",       "content-length", "content-type", "transfer-encoding",
+        "connection", "user-agent",     "expect",       "cookie",
+        "accept",     "authorization",  "referer",      "accept-encoding"};
+
+    // Perfect hash of the known names: (length + 4 * first + last) % 32 over lowercase bytes
+    // is different for each of them, so one slot and one comparison decide
+    static const Known KNOWN_SLOTS[32] = {
+        UNKNOWN_HEADER,          KNOWN_REFERER,      KNOWN_CONTENT_LENGTH,  UNKNOWN_HEADER,
+        KNOWN_CONNECTION,        UNKNOWN_HEADER,     UNKNOWN_HEADER,        UNKNOWN_HEADER,
+        KNOWN_TRANSFER_ENCODING, UNKNOWN_HEADER,     UNKNOWN_HEADER,        UNKNOWN_HEADER,
+        UNKNOWN_HEADER,          UNKNOWN_HEADER,     KNOWN_EXPECT,          UNKNOWN_HEADER,
+        UNKNOWN_HEADER,          UNKNOWN_HEADER,     KNOWN_USER_AGENT,      UNKNOWN_HEADER,
+        UNKNOWN_HEADER,          UNKNOWN_HEADER,     UNKNOWN_HEADER,        KNOWN_COOKIE,
+        KNOWN_HOST,              UNKNOWN_HEADER,     KNOWN_ACCEPT_ENCODING, UNKNOWN_HEADER,
+        UNKNOWN_HEADER,          KNOWN_CONTENT_TYPE, KNOWN_ACCEPT,          KNOWN_AUTHORIZATION};
+
+    Known classify(const char* name, size_t length) {
+        if (length == 0) {
+            return UNKNOWN_HEADER;
+        }
+        size_t hash = length + 4 * static_cast<unsigned char>(to_lower_ascii(name[0])) +
+                      static_cast<unsigned char>(to_lower_ascii(name[length - 1]));
+        Known known = KNOWN_SLOTS[hash % 32];
+        if (known == UNKNOWN_HEADER || !equals_insensitive(name, length, KNOWN_NAMES[known])) {
+            return UNKNOWN_HEADER;
+        }
+        return known;
+    }
 }  // namespace HttpHeaders
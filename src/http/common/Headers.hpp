@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@ namespace HttpHeaders {
     extern const HeaderName CONTENT_LENGTH;
     extern const HeaderName CONTENT_TYPE;
     extern const HeaderName COOKIE;
+    extern const HeaderName EXPECT;
     extern const HeaderName HOST;
     extern const HeaderName REFERER;
     extern const HeaderName USER_AGENT;
@@ -52,6 +54,28 @@ namespace HttpHeaders {
     extern const HeaderName SET_COOKIE;
     extern const HeaderName WWW_AUTHENTICATE;
 
+    // Request headers the server reads, recognized once when a field is stored so that
+    // looking them up is a slot access (HeaderTable)
+    enum Known {
+        KNOWN_HOST = 0,
+        KNOWN_CONTENT_LENGTH,
+        KNOWN_CONTENT_TYPE,
+        KNOWN_TRANSFER_ENCODING,
+        KNOWN_CONNECTION,
+        KNOWN_USER_AGENT,
+        KNOWN_EXPECT,
+        KNOWN_COOKIE,
+        KNOWN_ACCEPT,
+        KNOWN_AUTHORIZATION,
+        KNOWN_REFERER,
+        KNOWN_ACCEPT_ENCODING,
+        KNOWN_COUNT,
+        UNKNOWN_HEADER = KNOWN_COUNT
+    };
+
+    // Known id of a header name (case-insensitive), UNKNOWN_HEADER for any other name
+    Known classify(const char* name, size_t length);
+
     // Convert header name to lowercase for case-insensitive comparison
     inline std::string to_lowercase(const std::string& name) {
         std::string lowercase = name;
@@ -93,11 +117,57 @@ namespace HttpHeaders {
         return true;
     }
 
+    // ASCII lowercase, header names and tokens are ASCII (no locale lookup)
+    inline char to_lower_ascii(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    // Case-insensitive comparison of a name in place with a NUL-terminated one
+    inline bool equals_insensitive(const char* name, size_t length, const char* other) {
+        for (size_t i = 0; i < length; ++i) {
+            if (other[i] == '\0' || to_lower_ascii(name[i]) != to_lower_ascii(other[i])) {
+                return false;
+            }
+        }
+        return other[length] == '\0';
+    }
+
     // Check if a header value contains a specific token (case-insensitive)
+    inline bool value_contains(const char* value, size_t length, const char* token) {
+        size_t token_length = std::strlen(token);
+        for (size_t start = 0; start + token_length <= length; ++start) {
+            size_t i = 0;
+            while (i < token_length &&
+                   to_lower_ascii(value[start + i]) == to_lower_ascii(token[i])) {
+                i++;
+            }
+            if (i == token_length) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     inline bool value_contains(const std::string& value, const std::string& token) {
-        std::string lowercase_value = to_lowercase(value);
-        std::string lowercase_token = to_lowercase(token);
-        return lowercase_value.find(lowercase_token) != std::string::npos;
+        return value_contains(value.data(), value.length(), token.c_str());
+    }
+
+    // Content-Length value to a number: digits only, saturates instead of overflowing so
+    // that an oversized value still compares as too large
+    inline bool parse_content_length(const char* value, size_t length, size_t& result) {
+        if (length == 0) {
+            return false;
+        }
+        const size_t max_value = static_cast<size_t>(-1);
+        result = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (value[i] < '0' || value[i] > '9') {
+                return false;
+            }
+            size_t digit = value[i] - '0';
+            result = result > (max_value - digit) / 10 ? max_value : result * 10 + digit;
+        }
+        return true;
     }
 
     // Content-Length validation
@@ -144,35 +214,51 @@ namespace HttpHeaders {
     // Header classification functions for proper duplicate handling
     // according to RFC 7230 Section 3.2.2
 
+    // Name found in a NULL-terminated list of lowercase names
+    inline bool is_listed(const char* name, size_t length, const char* const* list) {
+        for (; *list; ++list) {
+            if (equals_insensitive(name, length, *list)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Headers that MUST only appear once (single-value headers)
-    inline bool is_single_value_header(const std::string& name) {
-        std::string lower_name = to_lowercase(name);
-        return (
-            lower_name == "content-length" || lower_name == "content-type" ||
-            lower_name == "date" || lower_name == "server" || lower_name == "location" ||
-            lower_name == "last-modified" || lower_name == "expires" || lower_name == "etag" ||
-            lower_name == "host" || lower_name == "authorization" || lower_name == "referer" ||
-            lower_name == "user-agent");
+    inline bool is_single_value_header(const char* name, size_t length) {
+        static const char* const names[] = {
+            "content-length", "content-type", "date",          "server",  "location",
+            "last-modified",  "expires",      "etag",          "host",    "authorization",
+            "referer",        "user-agent",   NULL};
+        return is_listed(name, length, names);
     }
 
     // Headers that can appear multiple times but should NOT be combined with commas
     // These are special cases that need individual header lines
-    inline bool is_special_multiple_header(const std::string& name) {
-        std::string lower_name = to_lowercase(name);
-        return (lower_name == "set-cookie" || lower_name == "www-authenticate");
+    inline bool is_special_multiple_header(const char* name, size_t length) {
+        static const char* const names[] = {"set-cookie", "www-authenticate", NULL};
+        return is_listed(name, length, names);
     }
 
     // Headers that can appear multiple times and CAN be combined with commas
+    inline bool is_combinable_header(const char* name, size_t length) {
+        static const char* const names[] = {
+            "accept",        "accept-charset",   "accept-encoding",  "accept-language",
+            "cache-control", "content-encoding", "content-language", "allow",
+            "pragma",        "warning",          NULL};
+        // X-* headers are commonly used for custom headers that should be combinable
+        return is_listed(name, length, names) ||
+               (length > 2 && to_lower_ascii(name[0]) == 'x' && name[1] == '-');
+    }
+
+    inline bool is_single_value_header(const std::string& name) {
+        return is_single_value_header(name.data(), name.length());
+    }
+    inline bool is_special_multiple_header(const std::string& name) {
+        return is_special_multiple_header(name.data(), name.length());
+    }
     inline bool is_combinable_header(const std::string& name) {
-        std::string lower_name = to_lowercase(name);
-        return (
-            lower_name == "accept" || lower_name == "accept-charset" ||
-            lower_name == "accept-encoding" || lower_name == "accept-language" ||
-            lower_name == "cache-control" || lower_name == "content-encoding" ||
-            lower_name == "content-language" || lower_name == "allow" || lower_name == "pragma" ||
-            lower_name == "warning" ||
-            // X-* headers are commonly used for custom headers that should be combinable
-            (lower_name.length() > 2 && lower_name.substr(0, 2) == "x-"));
+        return is_combinable_header(name.data(), name.length());
     }
 
     // Add header to multimap with RFC 7230 Section 3.2.2 compliance
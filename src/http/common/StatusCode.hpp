@@ -36,6 +36,7 @@ enum HttpStatusCode {
     PAYLOAD_TOO_LARGE = 413,
     URI_TOO_LONG = 414,
     UNSUPPORTED_MEDIA_TYPE = 415,
+    EXPECTATION_FAILED = 417,
     REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
 
     // 5xx Server Errors
@@ -107,6 +108,8 @@ inline const char* get_status_message(HttpStatusCode status) {
             return "URI Too Long";
         case UNSUPPORTED_MEDIA_TYPE:
             return "Unsupported Media Type";
+        case EXPECTATION_FAILED:
+            return "Expectation Failed";
 
         // 5xx Server Errors
         case INTERNAL_SERVER_ERROR:
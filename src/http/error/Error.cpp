@@ -50,12 +50,14 @@ bool HttpError::should_close_connection() const {
 
     // Specific client errors (4xx) that should close the connection
     switch (status_code_) {
-        case BAD_REQUEST:             // 400: Malformed request
-        case REQUEST_TIMEOUT:         // 408: Client took too long
-        case LENGTH_REQUIRED:         // 411: Missing Content-Length
-        case PAYLOAD_TOO_LARGE:       // 413: Request body too large
-        case URI_TOO_LONG:            // 414: URI exceeds server limits
-        case UNSUPPORTED_MEDIA_TYPE:  // 415: Unsupported content type
+        case BAD_REQUEST:                      // 400: Malformed request
+        case REQUEST_TIMEOUT:                  // 408: Client took too long
+        case LENGTH_REQUIRED:                  // 411: Missing Content-Length
+        case PAYLOAD_TOO_LARGE:                // 413: Request body too large
+        case URI_TOO_LONG:                     // 414: URI exceeds server limits
+        case UNSUPPORTED_MEDIA_TYPE:           // 415: Unsupported content type
+        case EXPECTATION_FAILED:               // 417: Body may follow, unread
+        case REQUEST_HEADER_FIELDS_TOO_LARGE:  // 431: Rest of the headers still unread
             return true;
         default:
             // For other client errors (404, 403, etc.), don't force close
@@ -11,19 +11,18 @@ HttpHandler::~HttpHandler() {
 }
 
 // Main request handler - validates method and dispatches to appropriate handler
-HttpResponse HttpHandler::handle_request(
-    const HttpRequest& request, const ServerBlock& server_block, const Connection* connection) {
+HttpResponse HttpHandler::handle_request(const HttpRequest& request, const Connection* connection) {
     HttpResponse response;
 
-    // Store reference to server block for later use
-    server_block_ = &server_block;
+    // Server block and location were resolved with the headers
+    const Route& route = request.get_route();
+    server_block_ = route.server;
+    const LocationBlock* location = route.location;
 
     HttpMethods::Method method = request.get_method();
-    std::string path = request.get_path();
-    const LocationBlock* location = NULL;
+    const std::string& path = request.get_path();
 
     try {
-        location = server_block.match_location(path);
         if (!location) {
             throw HttpError(NOT_FOUND, "No matching location block");
         }
@@ -58,7 +57,7 @@ HttpResponse HttpHandler::handle_request(
         // Handle the request based on method
         switch (method) {
             case HttpMethods::GET:
-                handle_get_request(request, path, response, location, connection);
+                handle_get_request(path, response, location, connection);
                 break;
 
             case HttpMethods::POST:
@@ -73,15 +72,22 @@ HttpResponse HttpHandler::handle_request(
                 throw HttpError(METHOD_NOT_ALLOWED, "Method not allowed for this resource");
         }
     } catch (const HttpError& e) {
-        response = create_error_response(e, server_block, location);
+        response = create_error_response(e, *server_block_, location);
     } catch (const std::exception& e) {
         // Wrap any standard exceptions in an HttpError
         HttpError server_error(INTERNAL_SERVER_ERROR, e.what());
-        response = create_error_response(server_error, server_block, location);
+        response = create_error_response(server_error, *server_block_, location);
     }
     return response;
 }
 
+// Same error pages as once the body is in, for a request refused with its headers
+HttpResponse HttpHandler::refuse_request(const HttpRequest& request, const HttpError& error) {
+    const Route& route = request.get_route();
+    server_block_ = route.server;
+    return create_error_response(error, *server_block_, route.location);
+}
+
 // Handle redirects properly
 void HttpHandler::handle_redirect(
     HttpResponse& response, const std::string& redirect_url, int status_code) {
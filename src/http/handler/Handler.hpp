@@ -17,9 +17,11 @@ class HttpHandler {
     explicit HttpHandler();
     ~HttpHandler();
 
-    HttpResponse handle_request(
-        const HttpRequest& request, const ServerBlock& server_block,
-        const Connection* connection = NULL);
+    // The request has been routed (HttpRequest::get_route()), its server is set
+    HttpResponse handle_request(const HttpRequest& request, const Connection* connection = NULL);
+
+    // Error response for a routed request refused before its body is read
+    HttpResponse refuse_request(const HttpRequest& request, const HttpError& error);
 
    private:
     // Reference to the current server block for path resolution
@@ -27,8 +29,8 @@ class HttpHandler {
 
     // Main handlers for HTTP methods
     void handle_get_request(
-        const HttpRequest& request, const std::string& path, HttpResponse& response,
-        const LocationBlock* location, const Connection* connection = NULL);
+        const std::string& path, HttpResponse& response, const LocationBlock* location,
+        const Connection* connection = NULL);
     void handle_post_request(
         const HttpRequest& request, HttpResponse& response, const LocationBlock* location,
         const Connection* connection = NULL);
@@ -37,7 +39,6 @@ class HttpHandler {
         const Connection* connection = NULL);
 
     // Helper methods for request validation
-    void validate_post_request(const HttpRequest& request, const LocationBlock* location);
     void validate_delete_operation(const std::string& file_path);
 
     // Handle redirects
@@ -54,7 +55,8 @@ class HttpHandler {
         const HttpRequest& request, const std::string& boundary, HttpResponse& response,
         const LocationBlock* location);
     bool handle_file_part(
-        const std::string& headers, const std::string& content, const LocationBlock* location);
+        const std::string& headers, const RequestBody& body, size_t content_offset,
+        size_t content_length, const LocationBlock* location);
     void parse_form_field(const std::string& field, FormDataMap& form_data);
     bool process_form_data(const FormDataMap& form_data, const LocationBlock* location);
 
@@ -112,8 +114,9 @@ class HttpHandler {
 
     // CGI handling
     bool is_cgi_request(const std::string& path, const LocationBlock* location) const;
+    // Runs on the connection's current request, whose body moves to the CGI
     HttpResponse handle_cgi_request(
-        const HttpRequest& request, const std::string& path, const LocationBlock* location,
+        const std::string& path, const LocationBlock* location,
         const Connection* connection = NULL);
     CgiComponentPair extract_cgi_components(
         const std::string& path, const LocationBlock* location) const;
@@ -94,8 +94,7 @@ std::pair<std::string, std::string> HttpHandler::extract_cgi_components(
 }
 
 HttpResponse HttpHandler::handle_cgi_request(
-    const HttpRequest& request, const std::string& path, const LocationBlock* location,
-    const Connection* connection) {
+    const std::string& path, const LocationBlock* location, const Connection* connection) {
     // Extract script path and PATH_INFO
     std::pair<std::string, std::string> cgi_components = extract_cgi_components(path, location);
     std::string script_name = cgi_components.first;
@@ -126,18 +125,14 @@ HttpResponse HttpHandler::handle_cgi_request(
         }
     }
 
-    // Create a modified request with PATH_INFO for the CGI executor
-    HttpRequest cgi_request = request;
-    cgi_request.set_path_info(path_info);
-    cgi_request.set_script_name(script_name);
-
     // Start non-blocking CGI execution
     if (!connection) {
         throw HttpError(INTERNAL_SERVER_ERROR, "No connection context for CGI execution");
     }
 
     Connection* conn = const_cast<Connection*>(connection);
-    if (!conn->start_cgi_execution(cgi_request, script_path, location)) {
+    // The connection runs the CGI on its current request, with SCRIPT_NAME and PATH_INFO set
+    if (!conn->start_cgi_execution(script_name, path_info, script_path, location)) {
         throw HttpError(INTERNAL_SERVER_ERROR, "Failed to start CGI execution");
     }
 
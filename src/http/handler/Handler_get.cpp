@@ -10,11 +10,11 @@
 #include <sys/stat.h>
 
 void HttpHandler::handle_get_request(
-    const HttpRequest& request, const std::string& path, HttpResponse& response,
-    const LocationBlock* location, const Connection* connection) {
+    const std::string& path, HttpResponse& response, const LocationBlock* location,
+    const Connection* connection) {
     // Check if this is a CGI request
     if (is_cgi_request(path, location)) {
-        response = handle_cgi_request(request, path, location, connection);
+        response = handle_cgi_request(path, location, connection);
         return;
     }
 
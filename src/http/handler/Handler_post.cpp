@@ -1,3 +1,4 @@
+#include <fcntl.h>
 #include <unistd.h>  // For access() function
 
 #include <cstring>
@@ -11,6 +12,7 @@
 // File upload and parsing constants
 static const size_t FILENAME_PREFIX_LENGTH = 10;   // Length of "filename=\""
 static const mode_t DIRECTORY_PERMISSIONS = 0777;  // Default directory creation permissions
+static const mode_t FILE_PERMISSIONS = 0666;       // Uploaded files, before the umask
 
 // POST Method implementation
 void HttpHandler::handle_post_request(
@@ -18,12 +20,11 @@ void HttpHandler::handle_post_request(
     const Connection* connection) {
     // Check if this is a CGI request
     if (is_cgi_request(request.get_path(), location)) {
-        response = handle_cgi_request(request, request.get_path(), location, connection);
+        response = handle_cgi_request(request.get_path(), location, connection);
         return;
     }
 
-    // Validate request and check size limits
-    validate_post_request(request, location);
+    // The body is within the location's client_max_body_size, enforced as it was read
 
     // Get the content type
     std::string content_type = request.get_header(HttpHeaders::CONTENT_TYPE);
@@ -42,18 +43,6 @@ void HttpHandler::handle_post_request(
     }
 }
 
-// Validate POST request and check size limits
-void HttpHandler::validate_post_request(const HttpRequest& request, const LocationBlock* location) {
-    // Check content length against location-specific limit
-    std::string content_length = request.get_header(HttpHeaders::CONTENT_LENGTH);
-    if (!content_length.empty()) {
-        size_t length = std::strtoul(content_length.c_str(), NULL, 10);
-        if (length > location->client_max_body_size) {
-            throw HttpError(PAYLOAD_TOO_LARGE, "Content length exceeds maximum allowed size");
-        }
-    }
-}
-
 // Handler for multipart/form-data (file uploads)
 void HttpHandler::handle_multipart_form_data(
     const HttpRequest& request, HttpResponse& response, const LocationBlock* location) {
@@ -77,29 +66,32 @@ void HttpHandler::process_multipart_upload(
         throw HttpError(FORBIDDEN, "File uploads are not configured on this server");
     }
 
-    std::string body = request.get_body();
+    // Parts are located by offset, the body may be a spooled file: only part headers are
+    // copied out, file contents go from the body to the upload file
+    const RequestBody& body = request.get_body();
+    std::string delimiter = "--" + boundary;
     size_t pos = 0;
     bool file_uploaded = false;
 
-    while ((pos = body.find("--" + boundary, pos)) != std::string::npos) {
-        pos += boundary.length() + 2;
-        size_t end_pos = body.find("--" + boundary, pos);
+    while ((pos = body.find(delimiter, pos)) != std::string::npos) {
+        pos += delimiter.length();
+        size_t end_pos = body.find(delimiter, pos);
         if (end_pos == std::string::npos) {
             break;
         }
 
-        std::string part = body.substr(pos, end_pos - pos);
+        size_t part_start = pos;
         pos = end_pos;
 
-        size_t header_end = part.find("\r\n\r\n");
-        if (header_end == std::string::npos) {
+        size_t header_end = body.find("\r\n\r\n", part_start);
+        if (header_end == std::string::npos || header_end + 4 > end_pos) {
             continue;
         }
 
-        std::string headers = part.substr(0, header_end);
-        std::string content = part.substr(header_end + 4);
+        std::string headers = body.substr(part_start, header_end - part_start);
+        size_t content_offset = header_end + 4;
 
-        if (handle_file_part(headers, content, location)) {
+        if (handle_file_part(headers, body, content_offset, end_pos - content_offset, location)) {
             file_uploaded = true;
         }
     }
@@ -122,7 +114,8 @@ void HttpHandler::process_multipart_upload(
 
 // Handle a single file part in multipart form data
 bool HttpHandler::handle_file_part(
-    const std::string& headers, const std::string& content, const LocationBlock* location) {
+    const std::string& headers, const RequestBody& body, size_t content_offset,
+    size_t content_length, const LocationBlock* location) {
     size_t filename_pos = headers.find("filename=\"");
     if (filename_pos == std::string::npos) {
         return false;
@@ -159,14 +152,25 @@ bool HttpHandler::handle_file_part(
         throw HttpError(CONFLICT, "File already exists: " + filename);
     }
 
-    std::ofstream file(file_path.c_str(), std::ios::out | std::ios::binary);
-
-    if (!file.is_open()) {
+    int file_fd =
+        open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, FILE_PERMISSIONS);
+    if (file_fd == -1) {
         throw HttpError(INTERNAL_SERVER_ERROR, "Failed to create file");
     }
 
-    file.write(content.c_str(), content.size());
-    file.close();
+    // Straight from the request body (sendfile() when it was spooled to disk)
+    size_t written = 0;
+    while (written < content_length) {
+        ssize_t result =
+            body.write_to(file_fd, content_offset + written, content_length - written);
+        if (result <= 0) {
+            close(file_fd);
+            unlink(file_path.c_str());
+            throw HttpError(INTERNAL_SERVER_ERROR, "Failed to write file");
+        }
+        written += result;
+    }
+    close(file_fd);
 
     Log::info("File uploaded: " + filename);
 
@@ -177,7 +181,8 @@ bool HttpHandler::handle_file_part(
 void HttpHandler::handle_urlencoded_form(
     const HttpRequest& request, HttpResponse& response, const LocationBlock* location) {
     // Parse and process the URL-encoded form data
-    std::string body = request.get_body();
+    // Forms are parsed whole, a spooled one is read back from its file here
+    std::string body = request.get_body().str();
     std::map<std::string, std::string> form_data;
 
     // Parse form data - split by & and then by =
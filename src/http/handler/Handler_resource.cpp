@@ -1,11 +1,39 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <fstream>
 
 #include "../../utils/Log.hpp"
 #include "../common/MimeTypes.hpp"
 #include "Handler.hpp"
 
+// Static file constants
+static const off_t FILE_BODY_MIN_SIZE = 16384;  // Smaller files are read into memory
+
 // Handle static file requests - main entry point for file serving
 void HttpHandler::handle_file_request(const std::string& file_path, HttpResponse& response) {
+    struct stat file_stat;
+    if (access(file_path.c_str(), R_OK) != 0 || stat(file_path.c_str(), &file_stat) != 0 ||
+        !S_ISREG(file_stat.st_mode)) {
+        throw HttpError(NOT_FOUND, "File not found");
+    }
+
+    // Set appropriate content type
+    std::string content_type = MimeTypes::get_type(file_path);
+
+    response.set_status(OK);
+    response.set_header(HttpHeaders::CONTENT_TYPE, content_type);
+
+    // Large files are sent from the file itself, memory use does not grow with their size
+    if (file_stat.st_size >= FILE_BODY_MIN_SIZE) {
+        FileBodySource* source = FileBodySource::open(file_path);
+        if (!source) {
+            throw HttpError(NOT_FOUND, "File not found");
+        }
+        response.set_body_source(source);
+        return;
+    }
+
     std::ifstream file(file_path.c_str(), std::ios::binary);
     if (!file.is_open()) {
         throw HttpError(NOT_FOUND, "File not found");
@@ -15,11 +43,6 @@ void HttpHandler::handle_file_request(const std::string& file_path, HttpResponse
     std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     file.close();
 
-    // Set appropriate content type
-    std::string content_type = MimeTypes::get_type(file_path);
-
-    response.set_status(OK);
-    response.set_header(HttpHeaders::CONTENT_TYPE, content_type);
     response.set_body(content);
 }
 
@@ -35,19 +58,16 @@ std::string HttpHandler::resolve_file_path(
     // Get the root directory for this location
     std::string root_dir = get_root_directory(location);
 
-    // Location matching is still done with the encoded path (already happened)
-    // But now decode the path when building the file path
-    std::string decoded_path = Uri::decode(request_path);
+    // The request path was decoded and normalized with the request line
 
     // Build the file path based on the type of match
     if (is_exact_match_for_location(request_path, location)) {
         return build_exact_match_path(root_dir, location);
     } else if (is_prefix_match_for_location(request_path, location)) {
-        // Use the decoded path when building the file path
-        return build_prefix_match_path(root_dir, decoded_path, location);
+        return build_prefix_match_path(root_dir, request_path, location);
     } else {
-        // For non-matches, use the decoded path with server root
-        return root_dir + decoded_path;
+        // For non-matches, use the path with server root
+        return root_dir + request_path;
     }
 }
 
@@ -102,12 +122,11 @@ std::string HttpHandler::build_prefix_match_path(
     }
 
     // Extract the part of the path after the location prefix
-    std::string location_path = location->path;
-    std::string decoded_location_path = Uri::decode(location_path);
+    const std::string& location_path = location->path;
 
     std::string remaining_path;
-    if (request_path.length() > decoded_location_path.length()) {
-        remaining_path = request_path.substr(decoded_location_path.length());
+    if (request_path.length() > location_path.length()) {
+        remaining_path = request_path.substr(location_path.length());
     }
 
     // Ensure remaining path starts with a slash if not empty
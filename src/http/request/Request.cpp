@@ -7,11 +7,10 @@
 
 #include "Request.hpp"
 
-#include <algorithm>
 #include <iostream>
-#include <sstream>
 
 #include "../../utils/Log.hpp"
+#include "../common/CharScan.hpp"
 #include "../common/Headers.hpp"
 #include "../common/Methods.hpp"
 #include "../error/Error.hpp"
@@ -21,12 +20,20 @@
 
 HttpRequest::HttpRequest()
     : method_(HttpMethods::UNKNOWN),
+      request_line_parsed_(false),
+      scan_offset_(0),
+      header_bytes_(0),
       headers_parsed_(false),
       complete_(false),
       chunked_(false),
-      current_chunk_size_(0),
+      chunk_state_(CHUNK_SIZE),
+      chunk_remaining_(0),
       max_content_length_(DEFAULT_MAX_CONTENT_LENGTH),
-      header_count_(0) {
+      max_header_section_(DEFAULT_MAX_HEADER_SECTION),
+      header_count_(0),
+      has_content_length_(false),
+      content_length_(0),
+      expects_continue_(false) {
 }
 
 HttpRequest::~HttpRequest() {
@@ -41,153 +48,140 @@ void HttpRequest::reset() {
     http_version_.clear();
     headers_.clear();
     body_.clear();
+    route_ = Route();
     path_info_.clear();
     script_name_.clear();
 
+    request_line_parsed_ = false;
+    scan_offset_ = 0;
+    header_bytes_ = 0;
     headers_parsed_ = false;
     complete_ = false;
     chunked_ = false;
-    request_buffer_.clear();
-    body_buffer_.clear();
-    current_chunk_size_ = 0;
+    chunk_state_ = CHUNK_SIZE;
+    chunk_remaining_ = 0;
+    chunk_line_.clear();
     header_count_ = 0;
-    // Keep max_content_length_ as it might be configured externally
+    has_content_length_ = false;
+    content_length_ = 0;
+    expects_continue_ = false;
+    // Keep max_content_length_ and max_header_section_ as they are configured externally
 }
 
-void HttpRequest::append_data(const std::string& data) {
-    // Add new data to the buffer
-    request_buffer_ += data;
-
-    // If already complete, don't parse again
+size_t HttpRequest::feed(const char* data, size_t length) {
+    // If already complete, nothing more belongs to this request
     if (complete_) {
-        return;
+        return 0;
     }
 
-    // Attempt to parse with current buffer contents
-    parse(request_buffer_);
+    // Attempt to parse with the received bytes
+    return parse(data, length);
 }
 
 // ------------------------------------------------------------------
 // Parsing
 
-void HttpRequest::parse(const std::string& raw_request) {
-    // Check for empty request
-    if (raw_request.empty()) {
-        throw HttpError(BAD_REQUEST, "Empty request");
+size_t HttpRequest::parse(const char* data, size_t length) {
+    if (headers_parsed_) {
+        return parse_body(data, length);
     }
 
-    // If we already have a complete request, don't parse again
-    if (complete_) {
-        return;
+    // Parse the request line and headers, each line as soon as it is complete
+    size_t consumed = parse_header_lines(data, length);
+    if (headers_parsed_) {
+        // The body is left for the next call: the caller may route the request or answer
+        // Expect: 100-continue in between, before any of it is read
+        begin_body();
     }
+    return consumed;
+}
 
-    // First, try to parse headers if they haven't been parsed yet
-    if (!headers_parsed_) {
-        // Check for complete headers
-        size_t header_end = raw_request.find("\r\n\r\n");
-        if (header_end == std::string::npos) {
-            return;  // Headers incomplete, need more data
-        }
-
-        // Split request into headers and body sections
-        std::string headers_section = raw_request.substr(0, header_end);
-        std::string remaining_data = raw_request.substr(header_end + 4);
-
-        // Parse request line
-        size_t first_line_end = headers_section.find("\r\n");
-        if (first_line_end == std::string::npos) {
-            throw HttpError(BAD_REQUEST, "Invalid request line");
-        }
-
-        std::string request_line = headers_section.substr(0, first_line_end);
-        std::string headers_content = headers_section.substr(first_line_end + 2);
-
-        parse_request_line(request_line);
-        parse_headers(headers_content);
-        validate_headers();
-
-        headers_parsed_ = true;
-
-        // If there's body data, update the request buffer to only contain the body
-        if (!remaining_data.empty()) {
-            request_buffer_ = remaining_data;
-        } else {
-            request_buffer_.clear();
-        }
+void HttpRequest::begin_body() {
+    // Special cases for requests without body
+    // RFC 7231: GET, HEAD, DELETE, OPTIONS, TRACE typically don't have bodies
+    if (method_ == HttpMethods::GET || method_ == HttpMethods::DELETE ||
+        method_ == HttpMethods::HEAD || method_ == HttpMethods::OPTIONS ||
+        method_ == HttpMethods::TRACE) {
+        complete_ = true;
+        return;
     }
 
-    // If headers are parsed, process the body if needed
-    if (headers_parsed_ && !complete_) {
-        // Special cases for requests without body
-        // RFC 7231: GET, HEAD, DELETE, OPTIONS, TRACE typically don't have bodies
-        if (method_ == HttpMethods::GET || method_ == HttpMethods::DELETE ||
-            method_ == HttpMethods::HEAD || method_ == HttpMethods::OPTIONS ||
-            method_ == HttpMethods::TRACE) {
+    // For other methods (POST, PUT, PATCH, etc.), check Content-Length
+    if (method_ == HttpMethods::POST || method_ == HttpMethods::PUT ||
+        method_ == HttpMethods::PATCH) {
+        // Content-Length was validated (400) and parsed with the headers.
+        // RFC 7230 3.3.3: without Content-Length and Transfer-Encoding the body is empty, and
+        // the bytes that follow are the next pipelined request
+        if (!has_content_length_ && !chunked_) {
             complete_ = true;
             return;
         }
 
-        // For other methods (POST, PUT, PATCH, etc.), check Content-Length
-        if (method_ == HttpMethods::POST || method_ == HttpMethods::PUT ||
-            method_ == HttpMethods::PATCH) {
-            std::string content_length = HttpHeaders::get(headers_, HttpHeaders::CONTENT_LENGTH);
-            std::string transfer_encoding =
-                HttpHeaders::get(headers_, HttpHeaders::TRANSFER_ENCODING);
-
-            bool has_content_length = !content_length.empty();
-            bool has_chunked_encoding = (transfer_encoding.find("chunked") != std::string::npos);
+        // If Content-Length is 0, request is complete
+        if (has_content_length_ && content_length_ == 0) {
+            complete_ = true;
+            return;
+        }
+    }
 
-            // RFC 7230: MUST return 411 if no Content-Length and no Transfer-Encoding
-            if (!has_content_length && !has_chunked_encoding && !request_buffer_.empty()) {
-                throw HttpError(LENGTH_REQUIRED, "Content-Length header required");
-            }
+    // For any other methods (CONNECT, custom methods), assume no body
+    if (method_ == HttpMethods::CONNECT || method_ == HttpMethods::UNKNOWN) {
+        complete_ = true;
+    }
+}
 
-            // If no Content-Length and no Transfer-Encoding, treat as complete with empty body
-            if (!has_content_length && !has_chunked_encoding) {
-                complete_ = true;
-                return;
+size_t HttpRequest::parse_header_lines(const char* data, size_t length) {
+    size_t consumed = 0;
+
+    while (!headers_parsed_) {
+        // Resume the search for the line end where the previous call stopped
+        const char* line = data + consumed;
+        size_t available = length - consumed;
+        const char* line_feed =
+            CharScan::find_line_end(line + scan_offset_, available - scan_offset_);
+        if (!line_feed) {
+            scan_offset_ = available;
+            if (header_bytes_ + available > max_header_section_) {
+                throw HttpError(REQUEST_HEADER_FIELDS_TOO_LARGE, "Request header too large");
             }
+            return consumed;  // The rest of the line stays buffered until it is complete
+        }
 
-            // Check for error 413 :
-            if (has_content_length) {
-                std::stringstream ss(content_length);
-                size_t body_size;
-                ss >> body_size;
-
-                // Check if conversion failed
-                if (ss.fail()) {
-                    throw HttpError(BAD_REQUEST, "Invalid Content-Length");
-                }
-
-                // Check against maximum allowed size
-                if (body_size > max_content_length_) {
-                    throw HttpError(PAYLOAD_TOO_LARGE, "Request entity too large");
-                }
-            }
+        size_t line_length = line_feed - line;
+        scan_offset_ = 0;
+        consumed += line_length + 1;
+        header_bytes_ += line_length + 1;
+        if (header_bytes_ > max_header_section_) {
+            throw HttpError(REQUEST_HEADER_FIELDS_TOO_LARGE, "Request header too large");
+        }
 
-            // If Content-Length is 0, request is complete
-            if (content_length == "0") {
-                complete_ = true;
-                return;
-            }
+        // Normalize line ending
+        if (line_length > 0 && line[line_length - 1] == '\r') {
+            line_length--;
         }
+        process_header_line(line, line_length);
+    }
+    return consumed;
+}
 
-        // For any other methods (CONNECT, custom methods), assume no body
-        if (method_ == HttpMethods::CONNECT || method_ == HttpMethods::UNKNOWN) {
-            complete_ = true;
+void HttpRequest::process_header_line(const char* line, size_t length) {
+    if (!request_line_parsed_) {
+        // RFC 7230, Section 3.5: empty lines ahead of the request line are ignored
+        if (length == 0) {
             return;
         }
+        parse_request_line(line, length);
+        request_line_parsed_ = true;
+        return;
+    }
 
-        // Process any body data we have
-        if (!request_buffer_.empty()) {
-            parse_body(request_buffer_);
-            // If using chunked encoding, keep the buffer for subsequent chunks
-            // Otherwise clear it as it's been processed
-            if (!chunked_ || complete_) {
-                request_buffer_.clear();
-            }
-        }
+    // An empty line ends the header section, the body (if any) starts right after it
+    if (length == 0) {
+        validate_headers();
+        headers_parsed_ = true;
+        return;
     }
+    parse_field_line(line, length);
 }
 
 // ------------------------------------------------------------------
@@ -199,16 +193,24 @@ HttpRequest::HttpRequest(const HttpRequest& other)
       http_version_(other.http_version_),
       headers_(other.headers_),
       body_(other.body_),
+      route_(other.route_),
       path_info_(other.path_info_),
       script_name_(other.script_name_),
+      request_line_parsed_(other.request_line_parsed_),
+      scan_offset_(other.scan_offset_),
+      header_bytes_(other.header_bytes_),
       headers_parsed_(other.headers_parsed_),
       complete_(other.complete_),
       chunked_(other.chunked_),
-      request_buffer_(other.request_buffer_),
-      body_buffer_(other.body_buffer_),
-      current_chunk_size_(other.current_chunk_size_),
+      chunk_state_(other.chunk_state_),
+      chunk_remaining_(other.chunk_remaining_),
+      chunk_line_(other.chunk_line_),
       max_content_length_(other.max_content_length_),
-      header_count_(other.header_count_) {
+      max_header_section_(other.max_header_section_),
+      header_count_(other.header_count_),
+      has_content_length_(other.has_content_length_),
+      content_length_(other.content_length_),
+      expects_continue_(other.expects_continue_) {
 }
 
 HttpRequest& HttpRequest::operator=(const HttpRequest& other) {
@@ -218,16 +220,24 @@ HttpRequest& HttpRequest::operator=(const HttpRequest& other) {
         http_version_ = other.http_version_;
         headers_ = other.headers_;
         body_ = other.body_;
+        route_ = other.route_;
         path_info_ = other.path_info_;
         script_name_ = other.script_name_;
+        request_line_parsed_ = other.request_line_parsed_;
+        scan_offset_ = other.scan_offset_;
+        header_bytes_ = other.header_bytes_;
         headers_parsed_ = other.headers_parsed_;
         complete_ = other.complete_;
         chunked_ = other.chunked_;
-        request_buffer_ = other.request_buffer_;
-        body_buffer_ = other.body_buffer_;
-        current_chunk_size_ = other.current_chunk_size_;
+        chunk_state_ = other.chunk_state_;
+        chunk_remaining_ = other.chunk_remaining_;
+        chunk_line_ = other.chunk_line_;
         max_content_length_ = other.max_content_length_;
+        max_header_section_ = other.max_header_section_;
         header_count_ = other.header_count_;
+        has_content_length_ = other.has_content_length_;
+        content_length_ = other.content_length_;
+        expects_continue_ = other.expects_continue_;
     }
     return *this;
 }
@@ -14,10 +14,13 @@
 #include <vector>
 
 #include "../../utils/Types.hpp"
+#include "../common/HeaderTable.hpp"
 #include "../common/Headers.hpp"
 #include "../common/Methods.hpp"
 #include "../error/Error.hpp"
 #include "../uri/Uri.hpp"
+#include "RequestBody.hpp"
+#include "Route.hpp"
 
 class HttpRequest {
    public:
@@ -25,7 +28,9 @@ class HttpRequest {
     static const size_t MAX_URI_LENGTH = 2048;                     // Common URI length limit
     static const size_t DEFAULT_MAX_CONTENT_LENGTH = 1048576 * 8;  // 8MB default
     static const size_t MAX_HEADER_SIZE = 8192;                    // 8KB header limit
+    static const size_t DEFAULT_MAX_HEADER_SECTION = 16384;        // Request line + headers
     static const size_t MAX_HEADERS = 100;                         // Maximum number of headers
+    static const size_t MAX_CHUNK_LINE = 4096;                     // Chunk size + extensions
 
     //-------------------------------------------------------------------------
     // Core functionality (Request.cpp)
@@ -38,8 +43,10 @@ class HttpRequest {
     // Reset request state for reuse
     void reset();
 
-    // Append raw HTTP request data and process it
-    void append_data(const std::string& data);
+    // Parse received bytes in place, returns how many were consumed. Bytes past the end of
+    // this request, or of a header line still incomplete, are left to the caller's buffer.
+    // A call that completes the header section stops there, the body starts with the next
+    size_t feed(const char* data, size_t length);
 
     // Copy support for connection management
     HttpRequest(const HttpRequest& other);
@@ -48,37 +55,41 @@ class HttpRequest {
     //-------------------------------------------------------------------------
     // Request line parsing (Request_line.cpp)
     //-------------------------------------------------------------------------
-    void parse_request_line(const std::string& line);
+    void parse_request_line(const char* line, size_t length);
     void validate_method(const std::string& method_str);
-    void validate_uri(const std::string& uri);
     void validate_http_version(const std::string& version);
 
     //-------------------------------------------------------------------------
     // Header parsing (Request_headers.cpp)
     //-------------------------------------------------------------------------
-    void parse_headers(const std::string& headers_section);
-    void store_header(const std::string& name, const std::string& value);
+    void parse_field_line(const char* line, size_t length);
+    void store_header(
+        const char* name, size_t name_length, const char* value, size_t value_length);
     void validate_headers();
     static std::string trim(const std::string& str);
 
-    // Header parsing helper methods (new)
-    void remove_carriage_return(std::string& line);
-    bool is_header_continuation(const std::string& line);
-    void store_pending_header(std::string& name, std::string& value);
+    // Header parsing helper methods, on lines in place (CRLF excluded)
+    bool is_header_continuation(const char* line, size_t length);
     void parse_header_line(
-        const std::string& line, std::string& header_name, std::string& header_value);
-    bool has_whitespace_before_colon(const std::string& line, size_t colon_pos);
-    bool is_malformed_header_line(const std::string& line, size_t first_colon);
-    void validate_header_name(const std::string& name);
-    void validate_header_value(const std::string& value);
+        const char* line, size_t length, size_t& name_length, size_t& value_start,
+        size_t& value_length);
+    bool has_whitespace_before_colon(const char* line, size_t colon_pos);
+    bool is_malformed_header_line(const char* line, size_t length, size_t first_colon);
+    void validate_header_name(const char* name, size_t length);
+    void validate_header_value(const char* value, size_t length);
     bool is_token_char(char c);
 
     //-------------------------------------------------------------------------
     // Body parsing (Request_body.cpp)
     //-------------------------------------------------------------------------
-    void parse_body(const std::string& data);
-    void parse_normal_body(const std::string& data);
-    void parse_chunked_body(const std::string& data);
+    size_t parse_body(const char* data, size_t length);
+    size_t parse_normal_body(const char* data, size_t length);
+    size_t parse_chunked_body(const char* data, size_t length);
+    bool next_chunk_line(
+        const char* data, size_t length, size_t& consumed, const char*& line,
+        size_t& line_length);
+    void process_chunk_line(const char* line, size_t length);
+    size_t parse_chunk_size(const char* line, size_t length);
 
     //-------------------------------------------------------------------------
     // Accessors (Request_accessors.cpp)
@@ -86,18 +97,38 @@ class HttpRequest {
     HttpMethods::Method get_method() const;
     const std::string& get_path() const;
     const std::string& get_query_string() const;
+    const std::string& get_request_uri() const;
     const std::string& get_http_version() const;
-    const std::string& get_body() const;
+    const RequestBody& get_body() const;
+
+    // Hand the body over to its consumer (CGI stdin): body receives it and the request is
+    // left with body's previous contents
+    void swap_body(RequestBody& body);
     std::string get_header(const std::string& name) const;
-    const HeaderMap& get_headers() const;
+    const HeaderTable& get_headers() const;
 
     // State checks
     bool is_complete() const;
+    bool has_complete_headers() const;
     bool is_chunked() const;
     bool is_keep_alive() const;
 
-    // Configuration
+    // Content-Length, parsed once with the headers (0 when absent)
+    bool has_content_length() const;
+    size_t get_content_length() const;
+
+    // Expect: 100-continue in an HTTP/1.1 request, the client waits before sending the body
+    bool expects_continue() const;
+
+    // Routing, done once the headers are parsed: the route's body limit replaces the
+    // configured one for the body to come
+    const Route& get_route() const;
+    void set_route(const Route& route);
+
+    // Configuration. The body limit applies from the first body byte on
     void set_max_content_length(size_t length);
+    void set_max_header_section(size_t size);
+    void set_body_buffering(size_t buffer_size, const std::string& temp_path);
 
     // CGI-specific setters and getters
     void set_path_info(const std::string& path_info) {
@@ -121,29 +152,48 @@ class HttpRequest {
     }
 
    private:
+    // Chunked decoder states (RFC 7230, Section 4.1)
+    enum ChunkState {
+        CHUNK_SIZE,      // chunk-size [ chunk-ext ] CRLF
+        CHUNK_DATA,      // chunk-data
+        CHUNK_DATA_END,  // CRLF after chunk-data
+        CHUNK_TRAILER    // trailer-part CRLF, after the last chunk
+    };
+
     // Request components
     HttpMethods::Method method_;
     Uri uri_;
     std::string http_version_;
-    HeaderMap headers_;  // RFC 7230 compliant header storage
-    std::string body_;
+    HeaderTable headers_;  // RFC 7230 compliant header storage
+    RequestBody body_;     // In memory, or spooled to a temporary file when large
+    Route route_;          // Server and location, set once the headers are parsed
 
     // CGI components
     std::string path_info_;    // PATH_INFO for CGI requests
     std::string script_name_;  // SCRIPT_NAME for CGI requests
 
     // Parsing state
+    bool request_line_parsed_;
+    size_t scan_offset_;   // Bytes of the current, incomplete line already searched for LF
+    size_t header_bytes_;  // Request line and header lines consumed so far
     bool headers_parsed_;
     bool complete_;
     bool chunked_;
-    std::string request_buffer_;  // Buffer for incoming request data
-    std::string body_buffer_;
-    size_t current_chunk_size_;
+    ChunkState chunk_state_;  // Where the chunked decoder is in the framing
+    size_t chunk_remaining_;  // Data bytes of the current chunk still to come
+    std::string chunk_line_;  // Start of a framing line split across reads, bounded
     size_t max_content_length_;
+    size_t max_header_section_;  // Largest request line + headers, 431 beyond
     size_t header_count_;
+    bool has_content_length_;
+    size_t content_length_;  // Content-Length value, valid when has_content_length_
+    bool expects_continue_;  // Expect: 100-continue (HTTP/1.1)
 
     // Main parsing entry point
-    void parse(const std::string& raw_request);
+    size_t parse(const char* data, size_t length);
+    size_t parse_header_lines(const char* data, size_t length);
+    void begin_body();
+    void process_header_line(const char* line, size_t length);
 
     // Path handling
     void normalize_path();
@@ -151,14 +201,11 @@ class HttpRequest {
 
     // Request line parsing helpers
     void extract_request_line_components(
-        const std::string& line, std::string& method_str, std::string& uri_string,
+        const char* line, size_t length, std::string& method_str, std::string& uri_string,
         std::string& version);
     void process_request_uri(const std::string& uri_string);
     void validate_uri_common(const std::string& uri_string);
     void process_absolute_uri(const std::string& uri_string, size_t scheme_end);
-
-    // Chunked encoding helpers
-    bool process_final_chunk();
 };
 
 #endif  // HTTP_REQUEST_HPP
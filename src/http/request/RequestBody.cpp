@@ -0,0 +1,224 @@
+#include "RequestBody.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "../error/Error.hpp"
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+const size_t RequestBody::DEFAULT_BUFFER_SIZE;
+const size_t RequestBody::SCAN_CHUNK_SIZE;
+
+static const char TEMP_FILE_TEMPLATE[] = "/webserv_body_XXXXXX";
+
+RequestBody::RequestBody()
+    : fd_(-1), spooled_size_(0), buffer_size_(DEFAULT_BUFFER_SIZE), temp_path_("/tmp") {
+}
+
+RequestBody::~RequestBody() {
+    close_file();
+}
+
+RequestBody::RequestBody(const RequestBody& other)
+    : memory_(other.memory_),
+      fd_(-1),
+      spooled_size_(other.spooled_size_),
+      buffer_size_(other.buffer_size_),
+      temp_path_(other.temp_path_) {
+    if (other.fd_ != -1) {
+        fd_ = fcntl(other.fd_, F_DUPFD_CLOEXEC, 0);
+        if (fd_ == -1) {
+            throw HttpError(INTERNAL_SERVER_ERROR, "Cannot share request body file");
+        }
+    }
+}
+
+RequestBody& RequestBody::operator=(const RequestBody& other) {
+    if (this != &other) {
+        RequestBody copy(other);
+        close_file();
+        memory_.swap(copy.memory_);
+        std::swap(fd_, copy.fd_);
+        spooled_size_ = copy.spooled_size_;
+        buffer_size_ = copy.buffer_size_;
+        temp_path_ = copy.temp_path_;
+    }
+    return *this;
+}
+
+void RequestBody::swap(RequestBody& other) {
+    memory_.swap(other.memory_);
+    std::swap(fd_, other.fd_);
+    std::swap(spooled_size_, other.spooled_size_);
+}
+
+void RequestBody::configure(size_t buffer_size, const std::string& temp_path) {
+    buffer_size_ = buffer_size;
+    temp_path_ = temp_path;
+}
+
+// ------------------------------------------------------------------
+// Filling
+
+void RequestBody::append(const char* data, size_t length) {
+    if (fd_ == -1 && memory_.size() + length > buffer_size_) {
+        spool();
+    }
+    if (fd_ == -1) {
+        memory_.append(data, length);
+        return;
+    }
+    write_file(data, length);
+}
+
+void RequestBody::clear() {
+    memory_.clear();
+    close_file();
+}
+
+void RequestBody::spool() {
+#if defined(__linux__) && defined(O_TMPFILE)
+    fd_ = open(temp_path_.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+#endif
+    if (fd_ == -1) {
+        // No O_TMPFILE here or on this filesystem: a named file, unlinked right away
+        std::string name = temp_path_ + TEMP_FILE_TEMPLATE;
+        std::vector<char> path(name.begin(), name.end());
+        path.push_back('\0');
+#ifdef __linux__
+        fd_ = mkostemp(&path[0], O_CLOEXEC);
+#else
+        fd_ = mkstemp(&path[0]);
+        if (fd_ != -1) {
+            fcntl(fd_, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        if (fd_ != -1) {
+            unlink(&path[0]);
+        }
+    }
+    if (fd_ == -1) {
+        throw HttpError(INTERNAL_SERVER_ERROR, "Cannot create request body temp file");
+    }
+
+    // Move what was buffered so far, and give the memory back
+    write_file(memory_.data(), memory_.size());
+    std::string().swap(memory_);
+}
+
+void RequestBody::write_file(const char* data, size_t length) {
+    // pwrite() at the end: copies of this body share the descriptor's file offset
+    while (length > 0) {
+        ssize_t written = pwrite(fd_, data, length, spooled_size_);
+        if (written <= 0) {
+            throw HttpError(INTERNAL_SERVER_ERROR, "Cannot write request body temp file");
+        }
+        data += written;
+        length -= written;
+        spooled_size_ += written;
+    }
+}
+
+void RequestBody::close_file() {
+    if (fd_ != -1) {
+        close(fd_);
+        fd_ = -1;
+    }
+    spooled_size_ = 0;
+}
+
+// ------------------------------------------------------------------
+// Reading
+
+size_t RequestBody::size() const {
+    return fd_ == -1 ? memory_.size() : spooled_size_;
+}
+
+bool RequestBody::empty() const {
+    return size() == 0;
+}
+
+bool RequestBody::is_spooled() const {
+    return fd_ != -1;
+}
+
+void RequestBody::read_file(size_t offset, char* buffer, size_t length) const {
+    while (length > 0) {
+        ssize_t bytes_read = pread(fd_, buffer, length, offset);
+        if (bytes_read <= 0) {
+            throw HttpError(INTERNAL_SERVER_ERROR, "Cannot read request body temp file");
+        }
+        buffer += bytes_read;
+        offset += bytes_read;
+        length -= bytes_read;
+    }
+}
+
+size_t RequestBody::find(const std::string& needle, size_t from) const {
+    if (fd_ == -1) {
+        return memory_.find(needle, from);
+    }
+
+    // Windows overlap by needle.length() - 1 so a match across two of them is still seen
+    size_t overlap = needle.empty() ? 0 : needle.length() - 1;
+    std::string window;
+    while (from < spooled_size_) {
+        size_t length = std::min(SCAN_CHUNK_SIZE + overlap, spooled_size_ - from);
+        window.resize(length);
+        read_file(from, &window[0], length);
+        size_t found = window.find(needle);
+        if (found != std::string::npos) {
+            return from + found;
+        }
+        if (from + length == spooled_size_) {
+            break;
+        }
+        from += length - overlap;
+    }
+    return std::string::npos;
+}
+
+std::string RequestBody::substr(size_t offset, size_t length) const {
+    if (fd_ == -1) {
+        return memory_.substr(offset, length);
+    }
+    if (offset >= spooled_size_) {
+        return "";
+    }
+    length = std::min(length, spooled_size_ - offset);
+    std::string bytes(length, '\0');
+    if (length > 0) {
+        read_file(offset, &bytes[0], length);
+    }
+    return bytes;
+}
+
+std::string RequestBody::str() const {
+    return substr(0, size());
+}
+
+ssize_t RequestBody::write_to(int fd, size_t offset, size_t length) const {
+    if (fd_ == -1) {
+        return write(fd, memory_.data() + offset, length);
+    }
+#ifdef __linux__
+    // Page cache to the pipe or file, the descriptor's own offset is left alone
+    off_t file_offset = offset;
+    return sendfile(fd, fd_, &file_offset, length);
+#else
+    char buffer[8192];  // No sendfile(): one pread() per call
+    ssize_t bytes_read = pread(fd_, buffer, std::min(length, sizeof(buffer)), offset);
+    if (bytes_read <= 0) {
+        return -1;
+    }
+    return write(fd, buffer, bytes_read);
+#endif
+}
@@ -0,0 +1,75 @@
+#ifndef REQUEST_BODY_HPP
+#define REQUEST_BODY_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <sys/types.h>
+
+/**
+ * Decoded body of a request: in memory while small, in an unlinked temporary file beyond a
+ * threshold (client_body_buffer_size).
+ *
+ * When an append would go past the threshold, the buffered bytes move to a file created in
+ * client_body_temp_path and later appends are written there. On Linux the file is opened
+ * with O_TMPFILE and never has a name; elsewhere, or if the filesystem lacks O_TMPFILE, it
+ * is created with mkstemp() and unlinked at once. Either way closing the descriptor frees
+ * the disk space.
+ *
+ * Consumers work on byte ranges, so a spooled body is never read back into memory whole:
+ * - find() and substr() serve the multipart parser
+ * - write_to() feeds upload files and CGI stdin, with sendfile() from a spooled file
+ */
+class RequestBody {
+   public:
+    static const size_t DEFAULT_BUFFER_SIZE = 16384;  // In memory up to this size
+
+    RequestBody();
+    ~RequestBody();
+
+    // Copies share the temporary file through their own descriptor
+    RequestBody(const RequestBody& other);
+    RequestBody& operator=(const RequestBody& other);
+
+    // Exchange contents without copying, each side keeps its spooling configuration
+    void swap(RequestBody& other);
+
+    // Spooling threshold and directory, kept across clear()
+    void configure(size_t buffer_size, const std::string& temp_path);
+
+    // Add decoded bytes, throws HttpError (500) if the temporary file cannot be written
+    void append(const char* data, size_t length);
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    bool is_spooled() const;
+
+    // Offset of the first needle at or after from, npos when there is none
+    size_t find(const std::string& needle, size_t from) const;
+
+    // Copy of the bytes [offset, offset + length)
+    std::string substr(size_t offset, size_t length) const;
+
+    // Whole body in one string, for small bodies parsed at once (URL-encoded forms)
+    std::string str() const;
+
+    // Write the start of [offset, offset + length) to fd: bytes written, or -1 like write()
+    ssize_t write_to(int fd, size_t offset, size_t length) const;
+
+   private:
+    static const size_t SCAN_CHUNK_SIZE = 65536;  // File bytes read per find() step
+
+    std::string memory_;     // The body while not spooled
+    int fd_;                 // Temporary file, -1 while in memory
+    size_t spooled_size_;    // Bytes in the temporary file
+    size_t buffer_size_;     // client_body_buffer_size
+    std::string temp_path_;  // client_body_temp_path
+
+    void spool();
+    void write_file(const char* data, size_t length);
+    void read_file(size_t offset, char* buffer, size_t length) const;
+    void close_file();
+};
+
+#endif  // REQUEST_BODY_HPP
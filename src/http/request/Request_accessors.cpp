@@ -22,15 +22,23 @@ const std::string& HttpRequest::get_query_string() const {
     return uri_.get_query_string();
 }
 
+const std::string& HttpRequest::get_request_uri() const {
+    return uri_.get_request_uri();
+}
+
 const std::string& HttpRequest::get_http_version() const {
     return http_version_;
 }
 
-const std::string& HttpRequest::get_body() const {
+const RequestBody& HttpRequest::get_body() const {
     return body_;
 }
 
-const HeaderMap& HttpRequest::get_headers() const {
+void HttpRequest::swap_body(RequestBody& body) {
+    body_.swap(body);
+}
+
+const HeaderTable& HttpRequest::get_headers() const {
     return headers_;
 }
 
@@ -38,26 +46,63 @@ bool HttpRequest::is_complete() const {
     return complete_;
 }
 
+bool HttpRequest::has_complete_headers() const {
+    return headers_parsed_;
+}
+
 bool HttpRequest::is_chunked() const {
     return chunked_;
 }
 
 bool HttpRequest::is_keep_alive() const {
-    std::string connection = HttpHeaders::get(headers_, HttpHeaders::CONNECTION);
+    size_t index = headers_.find(HttpHeaders::KNOWN_CONNECTION);
+    HeaderTable::Slice connection = {"", 0};
+    if (index < headers_.size()) {
+        connection = headers_.value_at(index);
+    }
 
     if (http_version_ == "HTTP/1.1") {
         // In HTTP/1.1, connections are keep-alive by default
-        return !HttpHeaders::value_contains(connection, "close");
+        return !HttpHeaders::value_contains(connection.data, connection.length, "close");
     } else {
         // In HTTP/1.0, connections are closed by default
-        return HttpHeaders::value_contains(connection, "keep-alive");
+        return HttpHeaders::value_contains(connection.data, connection.length, "keep-alive");
     }
 }
 
+bool HttpRequest::has_content_length() const {
+    return has_content_length_;
+}
+
+size_t HttpRequest::get_content_length() const {
+    return content_length_;
+}
+
+bool HttpRequest::expects_continue() const {
+    return expects_continue_;
+}
+
 std::string HttpRequest::get_header(const std::string& name) const {
-    return HttpHeaders::get(headers_, name);
+    return headers_.get(name.c_str());
+}
+
+const Route& HttpRequest::get_route() const {
+    return route_;
+}
+
+void HttpRequest::set_route(const Route& route) {
+    route_ = route;
+    max_content_length_ = route.max_body_size;
 }
 
 void HttpRequest::set_max_content_length(size_t length) {
     max_content_length_ = length;
 }
+
+void HttpRequest::set_max_header_section(size_t size) {
+    max_header_section_ = size;
+}
+
+void HttpRequest::set_body_buffering(size_t buffer_size, const std::string& temp_path) {
+    body_.configure(buffer_size, temp_path);
+}
@@ -15,153 +15,182 @@
  * @see RFC 7230, Section 4.1 (Chunked Transfer Coding)
  */
 
-#include <cstdlib>
+#include <algorithm>
+#include <cstring>
 
+#include "../common/CharScan.hpp"
 #include "../common/Headers.hpp"
 #include "../error/Error.hpp"
 #include "Request.hpp"
 
-void HttpRequest::parse_body(const std::string& data) {
+size_t HttpRequest::parse_body(const char* data, size_t length) {
     if (chunked_) {
-        parse_chunked_body(data);
-    } else {
-        parse_normal_body(data);
+        return parse_chunked_body(data, length);
     }
+    return parse_normal_body(data, length);
 }
 
-void HttpRequest::parse_normal_body(const std::string& data) {
-    // Using HttpHeaders utility instead of direct access
-    std::string content_length_str = HttpHeaders::get(headers_, HttpHeaders::CONTENT_LENGTH);
-
+size_t HttpRequest::parse_normal_body(const char* data, size_t length) {
     // Validate content length is present for POST requests
-    if (method_ == HttpMethods::POST && content_length_str.empty()) {
+    if (method_ == HttpMethods::POST && !has_content_length_) {
         throw HttpError(BAD_REQUEST, "Missing Content-Length for POST request");
     }
 
     // If no content length and not POST, we're done
-    if (content_length_str.empty()) {
+    if (!has_content_length_) {
         complete_ = true;
-        return;
+        return 0;
     }
 
-    // Parse content length
-    char* end;
-    unsigned long content_length = std::strtoul(content_length_str.c_str(), &end, 10);
-    if (*end != '\0') {
-        throw HttpError(BAD_REQUEST, "Invalid Content-Length value");
-    }
-
-    // Check against maximum allowed size
+    // Content-Length was parsed with the headers, the limit may have been set since
+    size_t content_length = content_length_;
     if (content_length > max_content_length_) {
         throw HttpError(PAYLOAD_TOO_LARGE);
     }
 
-    // Append new data
-    body_ += data;
+    // Append new data, what follows the body belongs to the next request
+    size_t taken = content_length - body_.size();
+    if (taken > length) {
+        taken = length;
+    }
+    body_.append(data, taken);
 
     // Check if we've received all the data
-    if (body_.length() >= content_length) {
-        if (body_.length() > content_length) {
-            // Truncate to exact content length
-            body_ = body_.substr(0, content_length);
-        }
+    if (body_.size() >= content_length) {
         complete_ = true;
     }
+    return taken;
 }
 
-void HttpRequest::parse_chunked_body(const std::string& data) {
-    // Append new data to existing body buffer
-    body_buffer_ += data;
-
-    // Process chunks until we need more data or reach the end
-    while (!body_buffer_.empty()) {
-        // If we're not currently processing a chunk, look for chunk size
-        if (current_chunk_size_ == 0) {
-            size_t line_end = body_buffer_.find("\r\n");
-            if (line_end == std::string::npos) {
-                return;  // Need more data to find the chunk size line
-            }
-
-            std::string chunk_header = body_buffer_.substr(0, line_end);
-
-            // Remove chunk extensions if present (separated by semicolon)
-            size_t semicolon = chunk_header.find(';');
-            if (semicolon != std::string::npos) {
-                chunk_header = chunk_header.substr(0, semicolon);
-            }
-
-            // Trim any potential whitespace
-            chunk_header = trim(chunk_header);
-
-            // Parse chunk size (hex value)
-            char* end;
-            current_chunk_size_ = std::strtoul(chunk_header.c_str(), &end, 16);
-            if (*end != '\0') {
-                throw HttpError(BAD_REQUEST, "Invalid chunk size: " + chunk_header);
-            }
-
-            // Remove chunk header from buffer
-            body_buffer_ = body_buffer_.substr(line_end + 2);
-
-            // If chunk size is 0, this is the last chunk
-            if (current_chunk_size_ == 0) {
-                // Handle the end of chunked message
-                process_final_chunk();
-                return;
+size_t HttpRequest::parse_chunked_body(const char* data, size_t length) {
+    // One pass over the received bytes: chunk data goes straight to the body, framing lines
+    // are parsed in place, and the decoder stops exactly at the end of the message
+    size_t consumed = 0;
+    while (!complete_ && consumed < length) {
+        if (chunk_state_ == CHUNK_DATA) {
+            size_t taken = std::min(chunk_remaining_, length - consumed);
+            body_.append(data + consumed, taken);
+            consumed += taken;
+            chunk_remaining_ -= taken;
+            if (chunk_remaining_ == 0) {
+                chunk_state_ = CHUNK_DATA_END;
             }
+            continue;
         }
 
-        // Process current chunk - do we have enough data?
-        if (body_buffer_.length() < current_chunk_size_ + 2) {
-            return;  // Need more data to complete this chunk
+        const char* line;
+        size_t line_length;
+        if (!next_chunk_line(data, length, consumed, line, line_length)) {
+            break;  // Line incomplete, its start is kept in chunk_line_
         }
+        process_chunk_line(line, line_length);
+        chunk_line_.clear();
+    }
+    return consumed;
+}
 
-        // We have enough data for this chunk - append to final body
-        body_ += body_buffer_.substr(0, current_chunk_size_);
+bool HttpRequest::next_chunk_line(
+    const char* data, size_t length, size_t& consumed, const char*& line, size_t& line_length) {
+    // Trailer fields are bounded like header fields, size lines by MAX_CHUNK_LINE
+    size_t limit = chunk_state_ == CHUNK_TRAILER ? max_header_section_ : MAX_CHUNK_LINE;
+    const char* start = data + consumed;
+    size_t available = length - consumed;
+    const char* line_feed = CharScan::find_line_end(start, available);
+    size_t taken = line_feed ? static_cast<size_t>(line_feed - start) : available;
+    if (chunk_line_.size() + taken > limit) {
+        throw HttpError(BAD_REQUEST, "Chunk framing line too long");
+    }
 
-        // Remove chunk data and CRLF from buffer
-        body_buffer_ = body_buffer_.substr(current_chunk_size_ + 2);
+    if (!line_feed) {
+        chunk_line_.append(start, available);
+        consumed = length;
+        return false;
+    }
+    consumed += taken + 1;
 
-        // Reset current chunk size to look for the next chunk
-        current_chunk_size_ = 0;
+    // Usually the whole line is in this read and is parsed where it lies
+    if (chunk_line_.empty()) {
+        line = start;
+        line_length = taken;
+    } else {
+        chunk_line_.append(start, taken);
+        line = chunk_line_.data();
+        line_length = chunk_line_.size();
+    }
+    if (line_length > 0 && line[line_length - 1] == '\r') {
+        line_length--;
     }
+    return true;
 }
 
-bool HttpRequest::process_final_chunk() {
-    // We've reached the zero-sized chunk
-    // Now we need to handle the final CRLF or any trailing headers
-
-    // Look for the terminating sequence (either just CRLF or CRLF CRLF for trailers)
-    size_t end_sequence = body_buffer_.find("\r\n\r\n");
+void HttpRequest::process_chunk_line(const char* line, size_t length) {
+    switch (chunk_state_) {
+        case CHUNK_SIZE:
+            chunk_remaining_ = parse_chunk_size(line, length);
+            if (chunk_remaining_ == 0) {
+                chunk_state_ = CHUNK_TRAILER;  // Last chunk
+            } else if (chunk_remaining_ > max_content_length_ - body_.size()) {
+                throw HttpError(PAYLOAD_TOO_LARGE, "Request entity too large");
+            } else {
+                chunk_state_ = CHUNK_DATA;
+            }
+            break;
 
-    // If we find CRLF CRLF, this indicates the end with potential trailers
-    if (end_sequence != std::string::npos) {
-        // If there's content before the double CRLF, it's trailer fields
-        if (end_sequence > 0) {
-            parse_headers(body_buffer_.substr(0, end_sequence));
-        }
+        case CHUNK_DATA_END:
+            if (length != 0) {
+                throw HttpError(BAD_REQUEST, "Missing CRLF after chunk data");
+            }
+            chunk_state_ = CHUNK_SIZE;
+            break;
+
+        case CHUNK_TRAILER:
+            // An empty line ends the message, trailer fields are stored like headers
+            if (length == 0) {
+                complete_ = true;
+                break;
+            }
+            header_bytes_ += length;
+            if (header_bytes_ > max_header_section_) {
+                throw HttpError(REQUEST_HEADER_FIELDS_TOO_LARGE, "Trailer section too large");
+            }
+            parse_field_line(line, length);
+            break;
 
-        // Request is complete - we've found the final boundary
-        complete_ = true;
-        return true;
+        case CHUNK_DATA:
+            break;  // Data is not line-based, parse_chunked_body() copies it
     }
+}
 
-    // Check for the simple case - just a CRLF with nothing after
-    if (body_buffer_ == "\r\n") {
-        complete_ = true;
-        return true;
+size_t HttpRequest::parse_chunk_size(const char* line, size_t length) {
+    // chunk-size = 1*HEXDIG, extensions after ';' are ignored (RFC 7230, Section 4.1.1)
+    const char* semicolon = static_cast<const char*>(std::memchr(line, ';', length));
+    size_t end = semicolon ? static_cast<size_t>(semicolon - line) : length;
+    size_t start = 0;
+    while (start < end && (line[start] == ' ' || line[start] == '\t')) {
+        start++;
     }
-
-    // Check if the buffer ends with CRLF and has no other data
-    if (body_buffer_.length() >= 2 && body_buffer_[body_buffer_.length() - 2] == '\r' &&
-        body_buffer_[body_buffer_.length() - 1] == '\n' &&
-        body_buffer_.find("\r\n") == body_buffer_.length() - 2) {
-        // This is a complete message with just CRLF at the end
-        complete_ = true;
-        return true;
+    while (end > start && (line[end - 1] == ' ' || line[end - 1] == '\t')) {
+        end--;
+    }
+    if (start == end) {
+        throw HttpError(BAD_REQUEST, "Missing chunk size");
     }
 
-    // If the buffer doesn't contain a complete trailer section or a final CRLF,
-    // we need more data - return false
-    return false;
+    size_t size = 0;
+    for (size_t i = start; i < end; ++i) {
+        char c = HttpHeaders::to_lower_ascii(line[i]);
+        size_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            throw HttpError(BAD_REQUEST, "Invalid chunk size");
+        }
+        if (size > (static_cast<size_t>(-1) >> 4)) {
+            throw HttpError(PAYLOAD_TOO_LARGE, "Chunk size too large");
+        }
+        size = (size << 4) | digit;
+    }
+    return size;
 }
@@ -9,7 +9,7 @@
  * @see RFC 7230, Section 5.3 (Request Target)
  */
 
-#include <sstream>
+#include <cctype>
 
 #include "../../utils/Log.hpp"
 #include "../common/Methods.hpp"
@@ -20,29 +20,19 @@
 static const int HTTP_STANDARD_PORT = 80;    // Standard HTTP port
 static const int HTTPS_STANDARD_PORT = 443;  // Standard HTTPS port
 
-void HttpRequest::parse_request_line(const std::string& line) {
+void HttpRequest::parse_request_line(const char* line, size_t length) {
     std::string method_str, uri_string, version;
 
     // Extract request line components
-    extract_request_line_components(line, method_str, uri_string, version);
+    extract_request_line_components(line, length, method_str, uri_string, version);
 
     // Validate components
     validate_method(method_str);
     validate_http_version(version);
 
-    // Check for URI size limit BEFORE general validation for his specific error code
-    if (!Uri::validate_uri_size(uri_string)) {
-        throw HttpError(URI_TOO_LONG, "URI too long");
-    }
-
-    // Validate URI length and characters
-    if (!Uri::validate_uri(uri_string)) {
-        throw HttpError(BAD_REQUEST, "Invalid URI");
-    }
-
-    // Parse URI (handles both absolute and relative forms)
-    // Note: Uri::parse() internally calls normalize_path() to handle path normalization
-    // including removal of dot segments (./ and ../) as per RFC 3986
+    // Parse URI (handles both origin and absolute forms) in one pass that validates it,
+    // decodes the path and removes its dot segments (./ and ../) as per RFC 3986. Throws
+    // 414 past the length limit, 400 for an invalid URI
     uri_.parse(uri_string);
 
     // If URI is absolute, extract the host for Host header
@@ -52,24 +42,37 @@ void HttpRequest::parse_request_line(const std::string& line) {
         if (uri_.get_port() != HTTP_STANDARD_PORT && uri_.get_port() != HTTPS_STANDARD_PORT) {
             host_value += ":" + HttpRequest::to_string(uri_.get_port());
         }
-        HttpHeaders::add_header(headers_, "Host", host_value);
+        headers_.add("Host", 4, host_value.data(), host_value.length());
     }
 }
 
 void HttpRequest::extract_request_line_components(
-    const std::string& line, std::string& method_str, std::string& uri_string,
+    const char* line, size_t length, std::string& method_str, std::string& uri_string,
     std::string& version) {
-    std::istringstream iss(line);
+    // Split on runs of whitespace, straight from the received line
+    std::string* components[] = {&method_str, &uri_string, &version};
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < length) {
+        if (std::isspace(static_cast<unsigned char>(line[pos]))) {
+            pos++;
+            continue;
+        }
+        size_t start = pos;
+        while (pos < length && !std::isspace(static_cast<unsigned char>(line[pos]))) {
+            pos++;
+        }
 
-    // Extract the three components
-    if (!(iss >> method_str >> uri_string >> version)) {
-        throw HttpError(BAD_REQUEST, "Malformed request line");
+        // Check for any extra components
+        if (count == 3) {
+            throw HttpError(BAD_REQUEST, "Extra components in request line");
+        }
+        components[count++]->assign(line + start, pos - start);
     }
 
-    // Check for any extra components
-    std::string extra;
-    if (iss >> extra) {
-        throw HttpError(BAD_REQUEST, "Extra components in request line");
+    // Expect the three components
+    if (count != 3) {
+        throw HttpError(BAD_REQUEST, "Malformed request line");
     }
 }
 
@@ -93,13 +96,6 @@ void HttpRequest::validate_method(const std::string& method_str) {
     // and return 405 Method Not Allowed if needed
 }
 
-void HttpRequest::validate_uri(const std::string& uri) {
-    // This method is now used for compatibility and redirects to Uri::validate_uri
-    if (!Uri::validate_uri(uri)) {
-        throw HttpError(BAD_REQUEST, "Invalid URI format");
-    }
-}
-
 void HttpRequest::validate_http_version(const std::string& version) {
     if (version != "HTTP/1.1" && version != "HTTP/1.0") {
         throw HttpError(HTTP_VERSION_NOT_SUPPORTED);
@@ -0,0 +1,24 @@
+#ifndef ROUTE_HPP
+#define ROUTE_HPP
+
+#include <cstddef>
+
+class ServerBlock;
+class LocationBlock;
+
+/**
+ * Where a request goes: its virtual server, its location and the limits that follow.
+ *
+ * Resolved once by the connection as soon as the header section is parsed, before any byte
+ * of the body is read, then carried by the request to the handler.
+ */
+struct Route {
+    const ServerBlock* server;      // Virtual server for the Host header and local port
+    const LocationBlock* location;  // Best matching location, NULL when none matches
+    size_t max_body_size;           // client_max_body_size in effect
+
+    Route() : server(NULL), location(NULL), max_body_size(0) {
+    }
+};
+
+#endif  // ROUTE_HPP
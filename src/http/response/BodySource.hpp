@@ -0,0 +1,101 @@
+#ifndef BODY_SOURCE_HPP
+#define BODY_SOURCE_HPP
+
+#include <sys/types.h>
+
+#include <string>
+
+/**
+ * Producer of a response body, pulled by the Connection while the socket is writable.
+ * In-memory bodies need none, they are queued as buffers of their own.
+ *
+ * - FileBodySource: a range of a file, sent with sendfile() where available
+ * - PipeBodySource: output of a running process (CGI), forwarded as it arrives
+ *
+ * A body whose length is only known once it ends is sent with Transfer-Encoding: chunked.
+ * Sources are reference counted so copies of an HttpResponse can share one; a source and
+ * all its references stay on the thread of a single connection.
+ */
+class BodySource {
+   public:
+    static const off_t UNKNOWN_LENGTH = -1;
+
+    BodySource();
+    virtual ~BodySource();
+
+    void retain();
+    void release();  // Deletes the source with its last reference
+
+    // Total length in bytes, UNKNOWN_LENGTH if it is only known at the end
+    virtual off_t get_length() const = 0;
+
+    // True once every byte has been produced
+    virtual bool is_exhausted() const = 0;
+
+    // Copy up to capacity bytes: bytes produced, 0 at the end of the body, -1 when nothing
+    // is available yet (wait for get_wait_fd() to become readable)
+    virtual ssize_t read(char* buffer, size_t capacity) = 0;
+
+    // Send up to max_bytes straight to a socket, without an intermediate copy: bytes sent,
+    // 0 if the source ended early, -1 if the socket would block. Needs has_direct_send()
+    virtual bool has_direct_send() const;
+    virtual ssize_t send_direct(int socket_fd, size_t max_bytes);
+
+    // Descriptor that becomes readable when read() can make progress again, -1 if none
+    virtual int get_wait_fd() const;
+
+   private:
+    int references_;
+
+    // Prevent copying
+    BodySource(const BodySource&);
+    BodySource& operator=(const BodySource&);
+};
+
+// Range of a regular file (the whole file by default), read through its own descriptor
+class FileBodySource : public BodySource {
+   public:
+    static const off_t TO_END = -1;
+
+    // Opens path for reading length bytes from offset, clamped to the file size. NULL if it
+    // cannot be opened or offset is past the end
+    static FileBodySource* open(const std::string& path, off_t offset = 0, off_t length = TO_END);
+    ~FileBodySource();
+
+    off_t get_length() const;
+    bool is_exhausted() const;
+    ssize_t read(char* buffer, size_t capacity);
+    bool has_direct_send() const;
+    ssize_t send_direct(int socket_fd, size_t max_bytes);
+
+   private:
+    static const off_t FADVISE_MIN_SIZE = 1048576;  // Sequential read-ahead hint from 1MB
+
+    int fd_;
+    off_t start_;   // First byte of the range
+    off_t offset_;  // Next byte to produce
+    off_t end_;     // End of the range, within the file size when it was opened
+
+    FileBodySource(int fd, off_t start, off_t end);
+};
+
+// Non-blocking pipe read until EOF, after the bytes already read from it (prefix)
+class PipeBodySource : public BodySource {
+   public:
+    PipeBodySource(int fd, const std::string& prefix, off_t length);
+    ~PipeBodySource();
+
+    off_t get_length() const;
+    bool is_exhausted() const;
+    ssize_t read(char* buffer, size_t capacity);
+    int get_wait_fd() const;
+
+   private:
+    int fd_;
+    std::string prefix_;   // Output read before the body started streaming
+    size_t prefix_sent_;   // Bytes of prefix_ already produced
+    off_t length_;         // Announced length, UNKNOWN_LENGTH if none
+    bool eof_;             // read() returned end of file
+};
+
+#endif  // BODY_SOURCE_HPP
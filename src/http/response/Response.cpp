@@ -1,20 +1,49 @@
 #include "Response.hpp"
 
-#include <ctime>
 #include <iostream>
 #include <sstream>
 
+#include "../../utils/Clock.hpp"
 #include "../../utils/Log.hpp"
 #include "../common/Headers.hpp"
 #include "../error/Error.hpp"
 
-HttpResponse::HttpResponse() : status_(OK) {
+HttpResponse::HttpResponse() : status_(OK), body_source_(NULL) {
     // Add by default
     set_date_header();
     set_header(HttpHeaders::SERVER, "WebServ");
 }
 
+HttpResponse::HttpResponse(const HttpResponse& other)
+    : status_(other.status_),
+      headers_(other.headers_),
+      body_(other.body_),
+      body_source_(other.body_source_) {
+    if (body_source_) {
+        body_source_->retain();
+    }
+}
+
+HttpResponse& HttpResponse::operator=(const HttpResponse& other) {
+    if (this != &other) {
+        if (other.body_source_) {
+            other.body_source_->retain();
+        }
+        if (body_source_) {
+            body_source_->release();
+        }
+        status_ = other.status_;
+        headers_ = other.headers_;
+        body_ = other.body_;
+        body_source_ = other.body_source_;
+    }
+    return *this;
+}
+
 HttpResponse::~HttpResponse() {
+    if (body_source_) {
+        body_source_->release();
+    }
 }
 
 void HttpResponse::set_status(HttpStatusCode status) {
@@ -29,13 +58,53 @@ void HttpResponse::set_header(const std::string& name, const std::string& value)
     HttpHeaders::add_header(headers_, normalized_name, value);
 }
 
+void HttpResponse::remove_header(const std::string& name) {
+    HeaderMapIt it = headers_.begin();
+    while (it != headers_.end()) {
+        if (HttpHeaders::compare_insensitive(it->first, name)) {
+            headers_.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void HttpResponse::set_body(const std::string& body) {
     body_ = body;
     // Automatically set Content-Length when body is set - using HttpHeaders constant
     set_header(HttpHeaders::CONTENT_LENGTH, Log::to_string(body_.size()));
+    remove_header(HttpHeaders::TRANSFER_ENCODING);
+    if (body_source_) {
+        body_source_->release();
+        body_source_ = NULL;
+    }
+}
+
+void HttpResponse::set_body_source(BodySource* source) {
+    if (body_source_) {
+        body_source_->release();
+    }
+    body_source_ = source;
+    body_.clear();
+
+    if (source->get_length() == BodySource::UNKNOWN_LENGTH) {
+        remove_header(HttpHeaders::CONTENT_LENGTH);
+        set_header(HttpHeaders::TRANSFER_ENCODING, "chunked");
+    } else {
+        remove_header(HttpHeaders::TRANSFER_ENCODING);
+        set_header(HttpHeaders::CONTENT_LENGTH, Log::to_string(source->get_length()));
+    }
+}
+
+void HttpResponse::swap_body(std::string& body) {
+    body_.swap(body);
 }
 
 std::string HttpResponse::build() const {
+    return build_headers() + body_;
+}
+
+std::string HttpResponse::build_headers() const {
     std::ostringstream response;
 
     // Status line
@@ -49,22 +118,12 @@ std::string HttpResponse::build() const {
     // Empty line to separate headers from body
     response << "\r\n";
 
-    // Add the body to the response
-    response << body_;
-
     return response.str();
 }
 
 void HttpResponse::set_date_header() {
-    char date_buf[100];
-    time_t now = time(0);
-    struct tm* tm_info = gmtime(&now);
-
-    // Format according to HTTP spec
-    strftime(date_buf, sizeof(date_buf), "%a, %d %b %Y %H:%M:%S GMT", tm_info);
-
-    // Using HttpHeaders constant
-    set_header(HttpHeaders::DATE, date_buf);
+    // Cached per second by the event loop clock, no time()/strftime() per response
+    set_header(HttpHeaders::DATE, Clock::http_date());
 }
 
 HttpResponse HttpResponse::build_default_error_response(const HttpError& error) {
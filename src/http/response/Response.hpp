@@ -1,24 +1,39 @@
 #ifndef HTTP_RESPONSE_HPP
 #define HTTP_RESPONSE_HPP
 
+#include <sys/types.h>
+
 #include <map>
 #include <string>
 
 #include "../../utils/Types.hpp"
 #include "../common/Headers.hpp"
 #include "../common/StatusCode.hpp"
+#include "BodySource.hpp"
 
 class HttpError;
 
 class HttpResponse {
    public:
     HttpResponse();
+    HttpResponse(const HttpResponse& other);
+    HttpResponse& operator=(const HttpResponse& other);
     ~HttpResponse();
 
     void set_status(HttpStatusCode status);
     void set_header(const std::string& name, const std::string& value);
+    void remove_header(const std::string& name);
     void set_body(const std::string& body);
     std::string build() const;
+    std::string build_headers() const;  // Status line and headers, up to the blank line
+
+    // Body pulled by the Connection while sending (takes the caller's reference): sets
+    // Content-Length, or Transfer-Encoding: chunked when the length is unknown
+    void set_body_source(BodySource* source);
+    BodySource* get_body_source() const {
+        return body_source_;
+    }
+    void swap_body(std::string& body);  // Moves the in-memory body out without copying
 
     static HttpResponse build_default_error_response(const HttpError& error);
 
@@ -33,6 +48,7 @@ class HttpResponse {
     HttpStatusCode status_;
     HeaderMap headers_;  // Changed from map to multimap
     std::string body_;
+    BodySource* body_source_;  // Streamed body (shared reference), NULL for in-memory bodies
 
     // Helper method to set Date header
     void set_date_header();
@@ -5,34 +5,44 @@
 #include <sstream>
 #include <string>
 
+/**
+ * Request target (RFC 7230, Section 5.3), in origin or absolute form.
+ *
+ * parse() reads the target once: it checks every byte against the URI_CHAR class of
+ * CharScan, percent-decodes the path, removes its dot segments and empty segments, and
+ * splits off the query string, writing the path into a single buffer sized up front. An
+ * invalid target throws HttpError (400, or 414 past MAX_URI_LENGTH).
+ *
+ * The path is decoded, so location matching and file lookup need no further decoding. A
+ * decoded '/' (%2F) separates segments like a literal one, so an encoded "../" cannot climb
+ * above the root. The query string stays as received; its parameters are split and decoded
+ * into a map only on the first get_query_param() or has_query_param().
+ */
 class Uri {
    public:
     // Constructors
     Uri();
     explicit Uri(const std::string& uri_string);
 
-    // Parse methods
+    // Parse methods, throw HttpError on an invalid target
     void parse(const std::string& uri_string);
 
     // Absolute URI handling
     bool is_absolute() const;
     static bool is_absolute_uri(const std::string& uri_string);
-    void parse_absolute_uri(const std::string& uri_string);
 
     // Accessor methods
-    const std::string& get_path() const;
-    const std::string& get_query_string() const;
+    const std::string& get_path() const;          // Decoded and normalized
+    const std::string& get_query_string() const;  // As received, without the '?'
+    const std::string& get_request_uri() const;   // Path and query as received (REQUEST_URI)
     const std::string& get_scheme() const;
     const std::string& get_host() const;
     int get_port() const;
 
-    // Query parameter methods
+    // Query parameter methods, parsed on first use
     std::string get_query_param(const std::string& param_name) const;
     bool has_query_param(const std::string& param_name) const;
 
-    // Manipulation methods
-    void normalize_path();
-
     // Utility methods
     template <typename T>
     static std::string to_string_uri(const T& value) {
@@ -41,14 +51,6 @@ class Uri {
         return oss.str();
     }
     std::string to_string() const;
-    bool is_valid() const;
-
-    // URI validation methods
-    static bool validate_uri(const std::string& uri);
-    static bool validate_uri_size(const std::string& uri);
-    static bool validate_uri_characters(const std::string& uri);
-    static bool validate_percent_encoding(const std::string& uri, size_t index);
-    static bool validate_uri_scheme(const std::string& uri);
 
     // Static utility methods
     static std::string encode(const std::string& str);
@@ -64,19 +66,21 @@ class Uri {
     static std::string extract_path(const std::string& uri);
 
    private:
-    std::string scheme_;                               // URI scheme (e.g., "http", "https")
-    std::string host_;                                 // Host component (e.g., "example.com")
-    int port_;                                         // Port number (e.g., 80, 443)
-    std::string path_;                                 // Path component (e.g., "/foo/bar")
-    std::string query_string_;                         // Raw query string (e.g., "a=1&b=2")
-    std::map<std::string, std::string> query_params_;  // Parsed query parameters
-    bool absolute_;                                    // Flag indicating if URI is absolute
-    bool valid_;                                       // Flag indicating if URI is valid
+    std::string scheme_;                                       // URI scheme (e.g., "http")
+    std::string host_;                                         // Host (e.g., "example.com")
+    int port_;                                                 // Port number (e.g., 80, 443)
+    std::string path_;                                         // Decoded path ("/foo/bar")
+    std::string query_string_;                                 // Raw query ("a=1&b=2")
+    std::string request_uri_;                                  // Raw path and query
+    mutable std::map<std::string, std::string> query_params_;  // Parsed on first lookup
+    mutable bool query_params_parsed_;                         // query_params_ is up to date
+    bool absolute_;                                            // URI is in absolute form
 
-    void extract_query_string(const std::string& uri);
-    void parse_query_params();
-    void validate();
+    size_t parse_absolute_uri(const std::string& uri_string);
     void extract_authority_components(const std::string& authority);
+    size_t parse_path(const char* data, size_t length);
+    void parse_query(const char* data, size_t length);
+    void parse_query_params() const;
 };
 
 #endif  // URI_HPP
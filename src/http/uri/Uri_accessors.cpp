@@ -3,6 +3,9 @@
 
 // Query parameter methods
 std::string Uri::get_query_param(const std::string& param_name) const {
+    if (!query_params_parsed_) {
+        parse_query_params();
+    }
     QueryParamMapConstIt it = query_params_.find(param_name);
     if (it != query_params_.end()) {
         return it->second;
@@ -11,6 +14,9 @@ std::string Uri::get_query_param(const std::string& param_name) const {
 }
 
 bool Uri::has_query_param(const std::string& param_name) const {
+    if (!query_params_parsed_) {
+        parse_query_params();
+    }
     return query_params_.find(param_name) != query_params_.end();
 }
 
@@ -19,7 +25,7 @@ std::string Uri::to_string() const {
     std::string result;
 
     if (absolute_) {
-        result = scheme_ + ":// ";
+        result = scheme_ + "://";
         result += host_;
 
         // Add port if non-standard
@@ -47,6 +53,10 @@ const std::string& Uri::get_query_string() const {
     return query_string_;
 }
 
+const std::string& Uri::get_request_uri() const {
+    return request_uri_;
+}
+
 const std::string& Uri::get_scheme() const {
     return scheme_;
 }
@@ -62,7 +72,3 @@ int Uri::get_port() const {
 bool Uri::is_absolute() const {
     return absolute_;
 }
-
-bool Uri::is_valid() const {
-    return valid_;
-}
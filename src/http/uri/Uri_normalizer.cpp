@@ -1,45 +1,107 @@
-#include <algorithm>
-#include <sstream>
-#include <vector>
-
+#include "../common/CharScan.hpp"
+#include "../error/Error.hpp"
 #include "Uri.hpp"
 
-// Path normalization and manipulation
-void Uri::normalize_path() {
-    if (path_.empty()) {
-        path_ = "/";
-        return;
+// Value of a hex digit, -1 for any other byte
+static int hex_value(unsigned char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20;  // Lowercase a letter
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
     }
+    return -1;
+}
 
-    // Replace backslashes with forward slashes
-    std::replace(path_.begin(), path_.end(), '\\', '/');
+// Decode the %XX at data[index], a malformed sequence or %00 is a bad request
+static unsigned char decode_percent(const char* data, size_t length, size_t index) {
+    if (index + 2 >= length) {
+        throw HttpError(BAD_REQUEST, "Invalid URI: truncated percent-encoding");
+    }
+    int high = hex_value(data[index + 1]);
+    int low = hex_value(data[index + 2]);
+    if (high < 0 || low < 0) {
+        throw HttpError(BAD_REQUEST, "Invalid URI: malformed percent-encoding");
+    }
+    if (high == 0 && low == 0) {
+        throw HttpError(BAD_REQUEST, "Invalid URL: contains null byte");
+    }
+    return static_cast<unsigned char>(high * 16 + low);
+}
 
-    // Handle multiple slashes
-    while (path_.find("// ") != std::string::npos) {
-        path_.replace(path_.find("// "), 2, "/");
+// Close the segment written from segment_start (just after its '/') to end, returns the new
+// end of the path. Empty and "." segments are dropped, ".." drops the previous one as well.
+static size_t close_segment(const char* path, size_t segment_start, size_t end) {
+    if (segment_start == 0) {
+        return end;  // No segment open yet
     }
+    size_t length = end - segment_start;
+    const char* segment = path + segment_start;
+    if (length == 0 || (length == 1 && segment[0] == '.')) {
+        return segment_start - 1;
+    }
+    if (length == 2 && segment[0] == '.' && segment[1] == '.') {
+        size_t slash = segment_start - 1;
+        while (slash > 0 && path[--slash] != '/') {
+        }
+        return slash;
+    }
+    return end;
+}
 
-    // Handle ./ and ../
-    std::vector<std::string> segments;
-    std::string segment;
-    std::istringstream path_stream(path_);
+// Validate, decode and normalize the path in one pass, returns the index of the '?' that
+// ends it, or length. The path is "/" followed by its segments, without a trailing slash.
+size_t Uri::parse_path(const char* data, size_t length) {
+    // Decoding never lengthens the path, one more byte covers the "/" of an empty one
+    path_.resize(length + 1);
+    char* path = &path_[0];
+    size_t end = 0;            // Path written so far
+    size_t segment_start = 0;  // First byte of the open segment, 0 before the first '/'
+
+    size_t i = 0;
+    for (; i < length; ++i) {
+        unsigned char c = data[i];
+        if (c == '?') {
+            break;
+        }
+        if (c == '%') {
+            c = decode_percent(data, length, i);
+            i += 2;
+        } else if (!CharScan::is_in_class(c, CharScan::URI_CHAR)) {
+            throw HttpError(BAD_REQUEST, "Invalid character in URI");
+        }
 
-    while (std::getline(path_stream, segment, '/')) {
-        if (segment == "..") {
-            if (!segments.empty()) {
-                segments.pop_back();
-            }
-        } else if (segment != "." && !segment.empty()) {
-            segments.push_back(segment);
+        // A decoded '/' separates segments too, so "..%2F" is a dot segment like "../"
+        if (c == '/') {
+            end = close_segment(path, segment_start, end);
+            path[end++] = '/';
+            segment_start = end;
+        } else {
+            path[end++] = c;
         }
     }
 
-    // Rebuild path
-    path_ = "/";
-    for (size_t i = 0; i < segments.size(); ++i) {
-        path_ += segments[i];
-        if (i < segments.size() - 1) {
-            path_ += "/";
+    end = close_segment(path, segment_start, end);
+    if (end == 0) {
+        path[end++] = '/';
+    }
+    path_.resize(end);
+    return i;
+}
+
+// Check the query string byte by byte, it is kept encoded
+void Uri::parse_query(const char* data, size_t length) {
+    // Control characters, non-ASCII, space and the characters that should be percent-encoded
+    // (< > " { } | \ ^ [ ] `) all end a run of URI_CHAR, so does '%'
+    size_t i = CharScan::span(data, length, CharScan::URI_CHAR);
+    while (i < length) {
+        if (data[i] != '%') {
+            throw HttpError(BAD_REQUEST, "Invalid character in URI");
         }
+        decode_percent(data, length, i);
+        i += 3;
+        i += CharScan::span(data + i, length - i, CharScan::URI_CHAR);
     }
+    query_string_.assign(data, length);
 }
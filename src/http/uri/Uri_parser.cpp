@@ -3,31 +3,57 @@
 #include <vector>
 
 #include "../../utils/Types.hpp"
+#include "../common/CharScan.hpp"
 #include "../error/Error.hpp"
 #include "Uri.hpp"
 
 // Constructors
-Uri::Uri() : port_(HTTP_DEFAULT_PORT), absolute_(false), valid_(true) {
+Uri::Uri() : port_(HTTP_DEFAULT_PORT), query_params_parsed_(false), absolute_(false) {
 }
 
-Uri::Uri(const std::string& uri_string) : port_(HTTP_DEFAULT_PORT), absolute_(false), valid_(true) {
+Uri::Uri(const std::string& uri_string)
+    : port_(HTTP_DEFAULT_PORT), query_params_parsed_(false), absolute_(false) {
     parse(uri_string);
 }
 
-// Main parsing method
+// Main parsing method: one pass over the target, see Uri.hpp
 void Uri::parse(const std::string& uri_string) {
-    // Check if this is an absolute URI
-    if (is_absolute_uri(uri_string)) {
-        parse_absolute_uri(uri_string);
-    } else {
-        // Handle relative URI
-        path_ = uri_string;
-        extract_query_string(uri_string);
-        normalize_path();
+    if (uri_string.empty()) {
+        throw HttpError(BAD_REQUEST, "Empty URI");
+    }
+    if (uri_string.length() > MAX_URI_LENGTH) {
+        throw HttpError(URI_TOO_LONG, "URI too long");
+    }
+
+    scheme_.clear();
+    host_.clear();
+    port_ = HTTP_DEFAULT_PORT;
+    absolute_ = false;
+    query_string_.clear();
+    query_params_.clear();
+    query_params_parsed_ = false;
+
+    // Origin form starts with the path, absolute form with "http://" or "https://"
+    size_t path_start = 0;
+    if (uri_string[0] != '/') {
+        if (!is_absolute_uri(uri_string)) {
+            throw HttpError(BAD_REQUEST, "Invalid URI");
+        }
+        path_start = parse_absolute_uri(uri_string);
     }
 
-    parse_query_params();
-    validate();
+    const char* data = uri_string.data() + path_start;
+    size_t length = uri_string.length() - path_start;
+    size_t path_end = parse_path(data, length);
+    if (path_end < length) {
+        parse_query(data + path_end + 1, length - path_end - 1);
+    }
+
+    if (length == 0) {
+        request_uri_ = "/";
+    } else {
+        request_uri_.assign(data, length);
+    }
 }
 
 // Check if URI is absolute
@@ -42,39 +68,31 @@ bool Uri::is_absolute_uri(const std::string& uri_string) {
     return false;
 }
 
-// Parse absolute URI (with scheme)
-void Uri::parse_absolute_uri(const std::string& uri_string) {
+// Parse the scheme and authority of an absolute URI, returns where its path starts
+size_t Uri::parse_absolute_uri(const std::string& uri_string) {
     size_t scheme_end = uri_string.find("://");
-    if (scheme_end == std::string::npos) {
-        return;  // Not an absolute URI
-    }
 
     // Extract scheme
     scheme_ = uri_string.substr(0, scheme_end);
     absolute_ = true;
 
-    // Find start of authority component
-    size_t authority_start = scheme_end + 3;  // Skip "://"
-
-    // Find end of authority component (first '/' after authority)
+    // Authority runs from after "://" to the first '/', or to the end without a path
+    size_t authority_start = scheme_end + 3;
     size_t path_start = uri_string.find('/', authority_start);
+    if (path_start == std::string::npos) {
+        path_start = uri_string.length();
+    }
 
-    // Extract authority (host:port)
-    std::string authority;
-    if (path_start != std::string::npos) {
-        authority = uri_string.substr(authority_start, path_start - authority_start);
-        // Extract path and query string
-        path_ = uri_string.substr(path_start);
-        extract_query_string(path_);
-    } else {
-        authority = uri_string.substr(authority_start);
-        path_ = "/";  // Default path is root
+    std::string authority = uri_string.substr(authority_start, path_start - authority_start);
+    if (CharScan::span(authority.data(), authority.length(), CharScan::URI_CHAR) !=
+        authority.length()) {
+        throw HttpError(BAD_REQUEST, "Invalid URI authority");
     }
 
     // Process authority (host:port)
     extract_authority_components(authority);
 
-    normalize_path();
+    return path_start;
 }
 
 // Extract host and port from authority component
@@ -104,17 +122,9 @@ void Uri::extract_authority_components(const std::string& authority) {
     }
 }
 
-// Separates path and query string from URI
-void Uri::extract_query_string(const std::string& uri) {
-    size_t query_pos = uri.find('?');
-    if (query_pos != std::string::npos) {
-        query_string_ = uri.substr(query_pos + 1);
-        path_ = uri.substr(0, query_pos);
-    }
-}
-
-// Parses query string into key-value pairs
-void Uri::parse_query_params() {
+// Parses query string into key-value pairs, on the first lookup
+void Uri::parse_query_params() const {
+    query_params_parsed_ = true;
     query_params_.clear();
     if (query_string_.empty()) {
         return;
@@ -0,0 +1,54 @@
+#include "BufferPool.hpp"
+
+const size_t BufferPool::MAX_FREE_PER_CLASS;
+
+BufferPool::BufferPool(size_t initial_size, size_t max_size) : initial_size_(initial_size) {
+    // Round the maximum up to a size class
+    size_t size = initial_size_;
+    size_t classes = 1;
+    while (size < max_size) {
+        size <<= 1;
+        classes++;
+    }
+    max_size_ = size;
+    free_lists_.resize(classes);
+}
+
+BufferPool::~BufferPool() {
+    for (size_t i = 0; i < free_lists_.size(); ++i) {
+        for (size_t j = 0; j < free_lists_[i].size(); ++j) {
+            delete[] free_lists_[i][j];
+        }
+    }
+}
+
+size_t BufferPool::next_size(size_t size) const {
+    return size < max_size_ ? size << 1 : 0;
+}
+
+char* BufferPool::acquire(size_t size) {
+    std::vector<char*>& free_list = free_lists_[class_index(size)];
+    if (free_list.empty()) {
+        return new char[size];
+    }
+    char* buffer = free_list.back();
+    free_list.pop_back();
+    return buffer;
+}
+
+void BufferPool::recycle(char* buffer, size_t size) {
+    std::vector<char*>& free_list = free_lists_[class_index(size)];
+    if (free_list.size() >= MAX_FREE_PER_CLASS) {
+        delete[] buffer;
+        return;
+    }
+    free_list.push_back(buffer);
+}
+
+size_t BufferPool::class_index(size_t size) const {
+    size_t index = 0;
+    for (size_t class_size = initial_size_; class_size < size; class_size <<= 1) {
+        index++;
+    }
+    return index;
+}
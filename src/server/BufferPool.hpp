@@ -0,0 +1,46 @@
+#ifndef BUFFERPOOL_HPP
+#define BUFFERPOOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Free lists of receive buffers, one pool per reactor (never shared between threads).
+ *
+ * Buffer sizes are size classes: the initial size doubled until it covers the maximum.
+ * Released buffers are kept for the next connection that needs one of the same class,
+ * up to MAX_FREE_PER_CLASS, so steady keep-alive traffic allocates nothing.
+ */
+class BufferPool {
+   public:
+    BufferPool(size_t initial_size, size_t max_size);
+    ~BufferPool();
+
+    size_t get_initial_size() const {
+        return initial_size_;
+    }
+    size_t get_max_size() const {
+        return max_size_;  // Largest size class
+    }
+
+    // Size class following size, 0 when size already is the largest one
+    size_t next_size(size_t size) const;
+
+    char* acquire(size_t size);  // size must be a size class
+    void recycle(char* buffer, size_t size);
+
+   private:
+    static const size_t MAX_FREE_PER_CLASS = 64;
+
+    size_t initial_size_;
+    size_t max_size_;
+    std::vector<std::vector<char*> > free_lists_;  // Indexed by size class
+
+    size_t class_index(size_t size) const;
+
+    // Prevent copying
+    BufferPool(const BufferPool&);
+    BufferPool& operator=(const BufferPool&);
+};
+
+#endif  // BUFFERPOOL_HPP
@@ -8,9 +8,10 @@
 #include <cstring>
 
 #include "../http/handler/Handler.hpp"
+#include "../utils/Clock.hpp"
 #include "../utils/Log.hpp"
-#include "Server.hpp"
 #include "Socket.hpp"
+#include "VirtualHosts.hpp"
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
@@ -20,28 +21,63 @@
 static const char LOCALHOST_IP[] = "127.0.0.1";
 static const int FALLBACK_SERVER_PORT = 8080;
 
+// Writes the "<hex size>\r\n" line of a chunk so that it ends at line_end, returns its start
+static char* write_chunk_size_line(char* line_end, size_t size) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    char* pos = line_end;
+    *--pos = '\n';
+    *--pos = '\r';
+    do {
+        *--pos = HEX_DIGITS[size & 0xF];
+        size >>= 4;
+    } while (size != 0);
+    return pos;
+}
+
 // Static member definitions
 const size_t Connection::MAX_REQUESTS;
 const time_t Connection::TIMEOUT;
 const size_t Connection::BUFFER_SIZE;
+const size_t Connection::CHUNK_SIZE_LINE_MAX;
+const size_t Connection::SENDFILE_CHUNK_SIZE;
+const size_t Connection::MAX_QUEUED_OUTPUT;
+const size_t Connection::MAX_QUEUED_SOURCES;
 
 // Constructor
-Connection::Connection(int client_fd, EventPoller& poller)
+Connection::Connection(
+    int client_fd, EventPoller& poller, BufferPool& buffer_pool, size_t max_header_size,
+    size_t body_buffer_size, const std::string& body_temp_path)
     : fd_(client_fd),
       poller_(poller),
-      last_activity_(time(NULL)),
+      last_activity_ms_(Clock::now_ms()),
       should_close_(false),
       request_count_(0),
+      recv_buffer_(buffer_pool),
+      body_waiting_(false),
+      body_produced_(0),
       request_in_progress_(false),
-      server_block_(NULL) {
+      request_routed_(false),
+      local_port_(0),
+      virtual_hosts_(NULL),
+      server_block_(NULL),
+      edge_triggered_(poller.is_edge_triggered()) {
+    current_request_.set_max_header_section(max_header_size);
+    current_request_.set_body_buffering(body_buffer_size, body_temp_path);
+
     // Register with poller for initial read events
-    poller_.watch_fd(fd_, PollEvents::READ);
+    short events = PollEvents::READ;
+    if (edge_triggered_) {
+        events |= PollEvents::EDGE;
+    }
+    poller_.watch_fd(fd_, events, FdOwner(FdOwner::CLIENT, this));
+    schedule_idle_timer();
 }
 
 // Destructor
 Connection::~Connection() {
     // Clean up any active CGI process first
     cgi_manager_.cleanup_cgi_process(this, poller_);
+    clear_output();
 
     if (fd_ != -1) {
         // Unregister from event polling
@@ -53,52 +89,92 @@ Connection::~Connection() {
 }
 
 void Connection::receive_client_data() {
-    // Don't receive if we're marked for closing
-    if (should_close_) {
+    // Reading is paused (closing, CGI running or output backlog): leave the data in the socket
+    if (!wants_read()) {
+        update_events(wanted_events());
         return;
     }
 
     try {
-        char buffer[BUFFER_SIZE];
-        ssize_t bytes_read = recv(fd_, buffer, BUFFER_SIZE, 0);
-
-        if (bytes_read > 0) {
-            // Data received successfully
-            std::string data(buffer, bytes_read);
-            update_activity_time();
-
-            // If no request is in progress, create a new one
-            if (!request_in_progress_) {
-                current_request_.reset();
-                request_in_progress_ = true;
+        bool keep_reading = true;
+
+        // Level-triggered: one recv() per wakeup. Edge-triggered: drain until recv() would block,
+        // the peer closes, or reading pauses (output backlogged, CGI running, closing); the
+        // events update re-arms READ once it is wanted again.
+        while (keep_reading) {
+            if (!recv_buffer_.prepare()) {
+                throw HttpError(REQUEST_HEADER_FIELDS_TOO_LARGE, "Request header too large");
+            }
+            size_t room = recv_buffer_.writable();
+            ssize_t bytes_read = recv(fd_, recv_buffer_.write_ptr(), room, 0);
+
+            if (bytes_read > 0) {
+                // Data received successfully, parsed where it landed
+                recv_buffer_.commit(bytes_read);
+                update_activity_time();
+                process_received_data();
+
+                // A read that filled the buffer gets a bigger one next time
+                if (static_cast<size_t>(bytes_read) == room) {
+                    recv_buffer_.grow();
+                }
+            } else if (bytes_read == 0) {
+                // Client closed connection
+                should_close_ = true;
+            } else if (!edge_triggered_) {
+                // recv() returned -1, could be EAGAIN/EWOULDBLOCK (expected) or real error
+                // Subject forbids checking errno, so we handle this gracefully
+                // For non-blocking sockets, this is expected when no data is available
+                Log::warn(
+                    "CONNECTION: fd=" + Log::to_string(fd_) +
+                    " recv() returned -1 (expected for non-blocking)");
             }
 
-            // Pass the new data to the request for parsing
-            current_request_.append_data(data);
+            keep_reading = edge_triggered_ && bytes_read > 0 && wants_read();
+        }
 
-            // If request is complete, process it
-            if (current_request_.is_complete()) {
-                handle_http_request();
-                request_in_progress_ = false;
-            }
-        } else if (bytes_read == 0) {
-            // Client closed connection
-            should_close_ = true;
-        } else {
-            // recv() returned -1, could be EAGAIN/EWOULDBLOCK (expected) or real error
-            // Subject forbids checking errno, so we handle this gracefully
-            // For non-blocking sockets, this is expected when no data is available
-            Log::warn(
-                "CONNECTION: fd=" + Log::to_string(fd_) +
-                " recv() returned -1 (expected for non-blocking)");
+        // Between requests nothing is buffered: an idle connection keeps no receive buffer
+        if (!request_in_progress_) {
+            recv_buffer_.release();
         }
 
         // Update poll events based on buffer states
-        short events = PollEvents::READ;
-        if (!response_buffer_.empty()) {
-            events |= PollEvents::WRITE;
+        update_events(wanted_events());
+    } catch (const HttpError& e) {
+        handle_http_error(e);
+    } catch (const std::exception& e) {
+        handle_http_error(HttpError(INTERNAL_SERVER_ERROR, e.what()));
+    }
+}
+
+void Connection::receive_completed_data(const char* data, size_t length) {
+    // Completion-based poller (io_uring): the kernel already received these bytes into one of
+    // its buffers. They go through the receive buffer like bytes from recv(); if reading has
+    // paused since the recv was submitted, they wait there until it resumes.
+    if (length == 0) {
+        should_close_ = true;  // Client closed connection
+        update_events(wanted_events());
+        return;
+    }
+
+    try {
+        update_activity_time();
+        while (length > 0) {
+            if (!recv_buffer_.prepare()) {
+                throw HttpError(REQUEST_HEADER_FIELDS_TOO_LARGE, "Request header too large");
+            }
+            size_t chunk = std::min(length, recv_buffer_.writable());
+            std::memcpy(recv_buffer_.write_ptr(), data, chunk);
+            recv_buffer_.commit(chunk);
+            data += chunk;
+            length -= chunk;
+            process_received_data();
         }
-        update_events(events);
+
+        if (!request_in_progress_) {
+            recv_buffer_.release();
+        }
+        update_events(wanted_events());
     } catch (const HttpError& e) {
         handle_http_error(e);
     } catch (const std::exception& e) {
@@ -108,25 +184,32 @@ void Connection::receive_client_data() {
 
 void Connection::send_response_data() {
     // Nothing to send
-    if (response_buffer_.empty()) {
+    if (!wants_write()) {
         return;
     }
 
     try {
-        ssize_t bytes_sent = send(fd_, response_buffer_.c_str(), response_buffer_.length(), 0);
+        ssize_t bytes_sent = 0;
 
-        if (bytes_sent > 0) {
-            // Update activity time and remove sent data from buffer
-            update_activity_time();
-            response_buffer_ = response_buffer_.substr(bytes_sent);
+        // Edge-triggered sockets keep writing until the queue is empty or send() would block
+        do {
+            bytes_sent = send_output();
+            if (bytes_sent > 0) {
+                update_activity_time();
+            }
+            if (output_.empty()) {
+                log_output_stats();
+            }
 
-            // Update poll events
-            short events = PollEvents::READ;
-            if (!response_buffer_.empty()) {
-                events |= PollEvents::WRITE;
+            // Pipelined requests held back by the output backlog can go on once it shrinks
+            if (bytes_sent > 0 || !wants_write()) {
+                process_received_data();
             }
-            update_events(events);
-        } else if (bytes_sent == -1) {
+        } while (edge_triggered_ && bytes_sent != -1 && wants_write());
+
+        if (bytes_sent != -1 || !wants_write()) {
+            update_events(wanted_events());
+        } else if (bytes_sent == -1 && !edge_triggered_) {
             // send() returned -1, could be EAGAIN/EWOULDBLOCK (expected) or real error
             // Subject forbids checking errno, so we handle this gracefully
             // For non-blocking sockets, this is expected when write would block
@@ -141,6 +224,21 @@ void Connection::send_response_data() {
     }
 }
 
+bool Connection::wants_read() const {
+    return !should_close_ && !output_backlogged() && !is_cgi_active();
+}
+
+short Connection::wanted_events() const {
+    short events = 0;
+    if (wants_read()) {
+        events |= PollEvents::READ;
+    }
+    if (wants_write()) {
+        events |= PollEvents::WRITE;
+    }
+    return events;
+}
+
 void Connection::close_on_error() {
     Log::error("Error on connection " + Log::to_string(fd_));
     should_close_ = true;
@@ -148,88 +246,171 @@ void Connection::close_on_error() {
 
 bool Connection::should_close() const {
     // Only close when marked AND all pending data has been sent
-    return should_close_ && response_buffer_.empty();
-}
-
-bool Connection::is_idle(time_t current_time) const {
-    time_t idle_time = current_time - last_activity_;
-    bool is_timeout = idle_time > TIMEOUT;
-
-    if (is_timeout) {
-        Log::warn(
-            "Connection " + Log::to_string(fd_) + " has been idle for " +
-            Log::to_string(idle_time) + " seconds, timing out.");
-        // Launch a timeout response
-        Connection* mutable_this = const_cast<Connection*>(this);
-        try {
-            mutable_this->send_timeout_response();
-        } catch (const HttpError& e) {
-            Log::error("Failed to send timeout response: " + std::string(e.what()));
-            mutable_this->handle_http_error(e);
-        }
+    return should_close_ && !has_pending_output();
+}
+
+void Connection::handle_idle_timer() {
+    long idle_ms = Clock::now_ms() - last_activity_ms_;
+
+    // Activity since the timer was armed: push the deadline instead of timing out
+    if (idle_ms < TIMEOUT * 1000) {
+        schedule_idle_timer();
+        return;
+    }
+
+    if (should_close_) {
+        // The 408 (or a previous response) could not be delivered in time, give up
+        Log::warn("Connection " + Log::to_string(fd_) + " stalled while closing, dropping it");
+        clear_output();
+        return;
     }
 
-    return is_timeout;
+    Log::warn(
+        "Connection " + Log::to_string(fd_) + " has been idle for " +
+        Log::to_string(idle_ms / 1000) + " seconds, timing out.");
+    // Launch a timeout response
+    try {
+        send_timeout_response();
+    } catch (const HttpError& e) {
+        Log::error("Failed to send timeout response: " + std::string(e.what()));
+        handle_http_error(e);
+    }
+    schedule_idle_timer();
 }
 
-void Connection::set_server_block(const ServerBlock* block) {
-    server_block_ = block;
+void Connection::set_listener(int local_port, const VirtualHosts* virtual_hosts) {
+    local_port_ = local_port;
+    virtual_hosts_ = virtual_hosts;
+    server_block_ = virtual_hosts ? virtual_hosts->get_default() : NULL;
 }
 
 void Connection::select_server_block_for_request() {
-    // Get the host header from the request
-    std::string host = current_request_.get_header(HttpHeaders::HOST);
-
-    // If no host header and HTTP/1.0, use default
-    if (host.empty() && current_request_.get_http_version() == "HTTP/1.0") {
-        host = "localhost";  // Fallback for HTTP/1.0 without Host
-        return;              // Keep existing server_block_
-    }
-
-    // Extract port from host if present (host:port format)
-    int port = -1;
-    size_t colon_pos = host.find(':');
-    if (colon_pos != std::string::npos) {
-        std::string port_str = host.substr(colon_pos + 1);
-        host = host.substr(0, colon_pos);
-        port = std::atoi(port_str.c_str());
-    } else {
-        // Try to determine port from the listening socket
-        for (SocketMapConstIt it = Server::get_listen_sockets().begin();
-             it != Server::get_listen_sockets().end(); ++it) {
-            if (it->second.get_fd() == fd_) {
-                port = it->first;
-                break;
-            }
-        }
+    if (!virtual_hosts_) {
+        return;
+    }
+
+    // Host is required in HTTP/1.1, an HTTP/1.0 request without one gets the default server
+    const HeaderTable& headers = current_request_.get_headers();
+    size_t index = headers.find(HttpHeaders::KNOWN_HOST);
+    if (index == headers.size()) {
+        server_block_ = virtual_hosts_->get_default();
+        return;
     }
 
-    // Update server block based on host and port if possible
-    if (!host.empty() && port != -1) {
-        const ServerBlock* matched_block = Server::get_server_block(host, port);
-        if (matched_block) {
-            server_block_ = matched_block;
+    HeaderTable::Slice host = headers.value_at(index);
+    server_block_ = virtual_hosts_->find(host.data, host.length);
+}
+
+void Connection::process_received_data() {
+    // Pipelined requests: every complete one buffered is handled in turn, its response queued
+    // behind the previous ones. A CGI or an output backlog holds the rest until it clears.
+    while (!recv_buffer_.empty() && wants_read()) {
+        // If no request is in progress, create a new one
+        if (!request_in_progress_) {
+            current_request_.reset();
+            request_in_progress_ = true;
+            request_routed_ = false;
+        }
+
+        // The request takes what belongs to it, anything after it stays buffered
+        size_t consumed = current_request_.feed(recv_buffer_.data(), recv_buffer_.size());
+        recv_buffer_.consume(consumed);
+        if (!current_request_.has_complete_headers()) {
+            return;  // Needs more data
         }
+
+        // Routed as soon as the headers are in, before any of the body is read
+        if (!request_routed_) {
+            route_request();
+        }
+        if (!current_request_.is_complete()) {
+            continue;  // The body is still coming
+        }
+
+        handle_http_request();
+        request_in_progress_ = false;
     }
 }
 
-void Connection::handle_http_request() {
+void Connection::route_request() {
+    request_routed_ = true;
+
     // Select the appropriate server block based on the request's Host header
     select_server_block_for_request();
-
-    // Verify we have a server block configuration
     if (!server_block_) {
-        handle_http_error(HttpError(INTERNAL_SERVER_ERROR, "No server configuration available"));
+        throw HttpError(INTERNAL_SERVER_ERROR, "No server configuration available");
+    }
+
+    Route route;
+    route.server = server_block_;
+    route.location = server_block_->match_location(current_request_.get_path());
+    route.max_body_size = route.location ? route.location->client_max_body_size
+                                         : server_block_->client_max_body_size;
+    current_request_.set_route(route);
+
+    if (!current_request_.is_complete()) {
+        admit_request_body();
+    }
+}
+
+void Connection::admit_request_body() {
+    const LocationBlock* location = current_request_.get_route().location;
+    try {
+        if (!location) {
+            throw HttpError(NOT_FOUND, "No matching location block");
+        }
+
+        // A redirect answers any method, the handler sends it once the body is in
+        HttpMethods::Method method = current_request_.get_method();
+        if (location->redirect.empty() &&
+            (!HttpMethods::is_implemented(method) || !location->is_allows_method(method))) {
+            throw HttpError(METHOD_NOT_ALLOWED, "Method not allowed for this resource");
+        }
+
+        // The parser holds a chunked body to the same limit as it is decoded
+        if (current_request_.has_content_length() &&
+            current_request_.get_content_length() > location->client_max_body_size) {
+            throw HttpError(PAYLOAD_TOO_LARGE, "Content length exceeds maximum allowed size");
+        }
+    } catch (const HttpError& e) {
+        Log::info(
+            HttpMethods::to_string(current_request_.get_method()) + " " +
+            current_request_.get_path() + " refused before its body: " + e.what());
+
+        // RFC 7231, Section 5.1.1: the body is left unread, so the connection cannot be reused
+        should_close_ = true;
+        HttpHandler handler;
+        HttpResponse response = handler.refuse_request(current_request_, e);
+        finish_response(response);
         return;
     }
 
+    // Interim response, queued behind earlier ones. Not needed once body bytes have arrived.
+    if (current_request_.expects_continue() && recv_buffer_.empty()) {
+        std::string interim("HTTP/1.1 100 Continue\r\n\r\n");
+        output_.push_back(interim);
+    }
+}
+
+void Connection::resume_requests() {
+    try {
+        process_received_data();
+        update_events(wanted_events());
+    } catch (const HttpError& e) {
+        handle_http_error(e);
+    } catch (const std::exception& e) {
+        handle_http_error(HttpError(INTERNAL_SERVER_ERROR, e.what()));
+    }
+}
+
+void Connection::handle_http_request() {
     Log::info(
         HttpMethods::to_string(current_request_.get_method()) + " " + current_request_.get_path());
     Log::debug(current_request_);
 
-    // Process the request and get a response, passing the server_block
+    // Process the request and get a response, on the route resolved with the headers
     HttpHandler handler;
-    HttpResponse response = handler.handle_request(current_request_, *server_block_, this);
+    HttpResponse response = handler.handle_request(current_request_, this);
 
     // Check if CGI is in progress (special header)
     if (response.get_header("X-CGI-Processing") == "true") {
@@ -237,9 +418,12 @@ void Connection::handle_http_request() {
     }
 
     Log::debug(response);
+    finish_response(response);
+}
 
-    // Decide on connection persistence using HttpRequest's method
-    bool keep_alive = current_request_.is_keep_alive();
+void Connection::finish_response(HttpResponse& response) {
+    // Decide on connection persistence using HttpRequest's method, unless closing already
+    bool keep_alive = !should_close_ && current_request_.is_keep_alive();
 
     // Set Connection header appropriately
     if (keep_alive) {
@@ -255,11 +439,160 @@ void Connection::handle_http_request() {
         should_close_ = true;
     }
 
-    // Build the response and store in buffer
-    response_buffer_ = response.build();
+    queue_response(response);
+}
+
+// ------------------------------------------------------------------
+// Response output
+
+void Connection::queue_response(HttpResponse& response) {
+    if (output_.empty()) {
+        output_.reset_stats();
+    }
 
-    // Update poll events to include writing
-    update_events(PollEvents::READ | PollEvents::WRITE);
+    BodySource* source = response.get_body_source();
+    bool chunked = false;
+    if (source && source->get_length() == BodySource::UNKNOWN_LENGTH) {
+        if (current_request_.get_http_version() == "HTTP/1.0") {
+            // No chunked coding in HTTP/1.0: closing the connection ends the body
+            response.remove_header(HttpHeaders::TRANSFER_ENCODING);
+            response.set_header(HttpHeaders::CONNECTION, "close");
+            should_close_ = true;
+        } else {
+            chunked = true;
+        }
+    }
+
+    std::string headers = response.build_headers();
+    output_.push_back(headers);
+    if (source) {
+        output_.push_source(source, chunked);
+        return;
+    }
+
+    // The body stays a segment of its own, it leaves with the headers in one writev()
+    std::string body;
+    response.swap_body(body);
+    output_.push_back(body);
+}
+
+ssize_t Connection::send_output() {
+    BodySource* source = output_.front_source();
+    if (source) {
+        if (!output_.front_chunked() && source->has_direct_send()) {
+            return send_body_direct();
+        }
+        pull_body_data();  // Queues the next piece ahead of the source, or ends or waits
+
+        if (output_.empty() || output_.front_source()) {
+            return 0;
+        }
+    }
+    return output_.write_to(fd_);
+}
+
+void Connection::pull_body_data() {
+    if (body_waiting_) {
+        return;
+    }
+
+    // Read straight into the queue's spare buffer, with room before the data for the chunk
+    // size line and after it for the CRLF, so a chunk goes out as one segment
+    std::string data;
+    output_.swap_spare(data);
+    bool chunked = output_.front_chunked();
+    size_t data_start = chunked ? CHUNK_SIZE_LINE_MAX : 0;
+    data.resize(data_start + BUFFER_SIZE + 2);
+    ssize_t produced = output_.front_source()->read(&data[data_start], BUFFER_SIZE);
+    if (produced <= 0) {
+        output_.swap_spare(data);
+        if (produced == 0) {
+            finish_body();
+        } else {
+            wait_for_body_source();
+        }
+        return;
+    }
+
+    body_produced_ += produced;
+    cgi_manager_.handle_stream_output(this);
+    size_t data_end = data_start + produced;
+    size_t segment_start = 0;
+    if (chunked) {
+        segment_start = write_chunk_size_line(&data[data_start], produced) - &data[0];
+        data[data_end++] = '\r';
+        data[data_end++] = '\n';
+    }
+    data.resize(data_end);
+    output_.push_front(data, segment_start);
+}
+
+ssize_t Connection::send_body_direct() {
+    ssize_t bytes_sent = output_.send_source_direct(fd_, SENDFILE_CHUNK_SIZE);
+    if (bytes_sent == 0) {
+        // The file shrank after Content-Length was sent, the response cannot be completed
+        Log::warn("Connection " + Log::to_string(fd_) + ": body truncated, closing");
+        clear_output();
+        should_close_ = true;
+    } else if (bytes_sent > 0 && output_.front_source()->is_exhausted()) {
+        output_.pop_source();
+    }
+    return bytes_sent;
+}
+
+void Connection::finish_body() {
+    off_t length = output_.front_source()->get_length();
+    bool chunked = output_.front_chunked();
+    if (!chunked && length != BodySource::UNKNOWN_LENGTH && body_produced_ != length) {
+        Log::warn("Connection " + Log::to_string(fd_) + ": body length mismatch, closing");
+        should_close_ = true;
+    }
+    output_.pop_source();
+    body_produced_ = 0;
+
+    if (chunked) {
+        std::string last_chunk("0\r\n\r\n");
+        output_.push_front(last_chunk);
+    }
+
+    // A streamed CGI can be reaped as soon as its output ended
+    cgi_manager_.handle_stream_end(this, poller_);
+}
+
+void Connection::wait_for_body_source() {
+    body_waiting_ = true;
+    poller_.watch_fd(
+        output_.front_source()->get_wait_fd(), PollEvents::READ,
+        FdOwner(FdOwner::BODY_SOURCE, this));
+}
+
+void Connection::resume_body_source() {
+    if (!body_waiting_) {
+        return;
+    }
+    poller_.unwatch_fd(output_.front_source()->get_wait_fd());
+    body_waiting_ = false;
+    send_response_data();
+}
+
+void Connection::clear_output() {
+    if (body_waiting_) {
+        poller_.unwatch_fd(output_.front_source()->get_wait_fd());
+        body_waiting_ = false;
+    }
+    output_.clear();
+    body_produced_ = 0;
+}
+
+void Connection::log_output_stats() const {
+    if (Log::get_level() > Log::DEBUG) {
+        return;
+    }
+    const OutputQueue::Stats& stats = output_.get_stats();
+    Log::debug(
+        "Connection " + Log::to_string(fd_) + ": sent " + Log::to_string(stats.bytes_sent) +
+        " bytes (" + Log::to_string(stats.bytes_queued) + " buffered) in " +
+        Log::to_string(stats.send_calls) + " send calls");
 }
 
 void Connection::handle_http_error(const HttpError& error) {
@@ -291,11 +624,9 @@ void Connection::handle_http_error(const HttpError& error) {
             }
         }
 
-        // Set the response buffer
-        response_buffer_ = response.build();
-
-        // Update poll events to include writing
-        update_events(PollEvents::WRITE);
+        // Queued behind the responses of earlier pipelined requests
+        queue_response(response);
+        update_events(wanted_events());
     } catch (const std::exception& e) {
         // Critical failure, just mark for closing
         Log::error("Failed to create error response: " + std::string(e.what()));
@@ -326,11 +657,9 @@ std::string Connection::get_client_host() const {
 
 // Get server port from the server block configuration
 int Connection::get_server_port() const {
-    if (server_block_) {
-        const ListenVector& listen_pairs = server_block_->listen;
-        if (!listen_pairs.empty()) {
-            return listen_pairs[0].second;  // Return the port from the first listen directive
-        }
+    // Port of the listening socket, recorded at accept
+    if (local_port_ > 0) {
+        return local_port_;
     }
 
     // Fallback: try to get port from socket
@@ -346,10 +675,23 @@ int Connection::get_server_port() const {
 }
 
 void Connection::update_activity_time() {
-    last_activity_ = time(NULL);
+    // The idle timer is not touched here, it re-arms itself from this timestamp when it fires
+    last_activity_ms_ = Clock::now_ms();
+}
+
+void Connection::schedule_idle_timer() {
+    long deadline_ms = last_activity_ms_ + TIMEOUT * 1000;
+    if (deadline_ms <= Clock::now_ms()) {
+        // Already timed out (408 pending): allow one more period to deliver it
+        deadline_ms = Clock::now_ms() + TIMEOUT * 1000;
+    }
+    poller_.set_timer(fd_, Timers::IDLE, deadline_ms);
 }
 
 void Connection::update_events(short events) {
+    if (edge_triggered_) {
+        events |= PollEvents::EDGE;
+    }
     poller_.update_events(fd_, events);
 }
 
@@ -358,17 +700,25 @@ void Connection::send_timeout_response() {
 }
 
 // CGI handling methods
+// The CGI runs on current_request_ itself: no copy, its body moves to the CGI state
 bool Connection::start_cgi_execution(
-    const HttpRequest& request, const std::string& script_path, const LocationBlock* location) {
-    return cgi_manager_.start_cgi_execution(request, script_path, location, this, poller_);
+    const std::string& script_name, const std::string& path_info,
+    const std::string& script_path, const LocationBlock* location) {
+    current_request_.set_script_name(script_name);
+    current_request_.set_path_info(path_info);
+    return cgi_manager_.start_cgi_execution(
+        current_request_, script_path, location, this, poller_);
 }
 
 void Connection::handle_cgi_completion() {
     cgi_manager_.handle_cgi_completion(this, poller_);
 }
 
-void Connection::handle_cgi_timeout() {
-    cgi_manager_.handle_cgi_timeout(this, poller_);
+void Connection::handle_cgi_timer() {
+    cgi_manager_.update_cgi_process(this, poller_);
+
+    // A reaped CGI no longer holds back the requests pipelined behind it
+    resume_requests();
 }
 
 void Connection::cleanup_cgi_process() {
@@ -376,10 +726,19 @@ void Connection::cleanup_cgi_process() {
 }
 
 // Methods for CgiManager to access connection internals
-void Connection::set_response_from_cgi(const std::string& response_data) {
-    response_buffer_ = response_data;
-    // Update events to include writing
-    update_events(PollEvents::READ | PollEvents::WRITE);
+void Connection::set_response_from_cgi(HttpResponse& response) {
+    // The CGI request is still current_request_, nothing after it was parsed yet
+    finish_response(response);
+    update_events(wanted_events());
+}
+
+void Connection::close_after_response() {
+    should_close_ = true;
+}
+
+void Connection::abort_response() {
+    clear_output();
+    should_close_ = true;
 }
 
 void Connection::send_error_response(HttpStatusCode status, const std::string& message) {
@@ -1,6 +1,8 @@
 #ifndef CONNECTION_HPP
 #define CONNECTION_HPP
 
+#include <sys/types.h>
+
 #include <ctime>
 #include <string>
 
@@ -11,6 +13,8 @@
 #include "../http/response/Response.hpp"
 #include "../utils/Types.hpp"
 #include "EventPoller.hpp"
+#include "OutputQueue.hpp"
+#include "RecvBuffer.hpp"
 
 /**
  * Manages a client connection, handling request/response lifecycle.
@@ -24,21 +28,25 @@
  */
 class Connection {
    public:
-    // Constructor takes client socket fd and reference to event poller
-    Connection(int client_fd, EventPoller& poller);
+    // Constructor takes client socket fd, the event poller, the pool of receive buffers and
+    // the request limits of the main context
+    Connection(
+        int client_fd, EventPoller& poller, BufferPool& buffer_pool, size_t max_header_size,
+        size_t body_buffer_size, const std::string& body_temp_path);
 
     // Destructor ensures socket cleanup
     ~Connection();
 
     void receive_client_data();
+    void receive_completed_data(const char* data, size_t length);  // Received by the poller
     void send_response_data();
     void close_on_error();
     bool should_close() const;
-    bool is_idle(time_t current_time) const;
+    void handle_idle_timer();
     int get_fd() const {
         return fd_;
     }
-    void set_server_block(const ServerBlock* block);
+    void set_listener(int local_port, const VirtualHosts* virtual_hosts);
 
     // Methods for CGI environment
     std::string get_client_ip() const;
@@ -47,14 +55,20 @@ class Connection {
 
     // CGI integration with CgiManager
     bool start_cgi_execution(
-        const HttpRequest& request, const std::string& path, const LocationBlock* location);
+        const std::string& script_name, const std::string& path_info,
+        const std::string& script_path, const LocationBlock* location);
     void handle_cgi_completion();
-    void handle_cgi_timeout();
+    void handle_cgi_timer();
     void cleanup_cgi_process();
 
     // Methods for CgiManager to access connection internals
-    void set_response_from_cgi(const std::string& response_data);
+    void set_response_from_cgi(HttpResponse& response);
     void send_error_response(HttpStatusCode status, const std::string& message);
+    void close_after_response();  // Close once the current response is out
+    void abort_response();        // Drop a response whose headers may already be out
+
+    // The body source being waited on can make progress again
+    void resume_body_source();
 
     // CGI state access (for CgiManager)
     bool is_cgi_active() const;
@@ -66,7 +80,11 @@ class Connection {
     // Connection constants
     static const size_t MAX_REQUESTS = 100;   // Maximum requests per connection
     static const time_t TIMEOUT = 60;         // Connection timeout in seconds
-    static const size_t BUFFER_SIZE = 32768;  // Read buffer size (32KB)
+    static const size_t BUFFER_SIZE = 32768;  // Body source read size (32KB)
+    static const size_t CHUNK_SIZE_LINE_MAX = 2 * sizeof(size_t) + 2;  // Hex digits, CRLF
+    static const size_t SENDFILE_CHUNK_SIZE = 524288;  // Largest file slice per send (512KB)
+    static const size_t MAX_QUEUED_OUTPUT = 262144;    // Buffered output that pauses reading
+    static const size_t MAX_QUEUED_SOURCES = 8;        // Streamed bodies that pause reading
     // Buffer size recommendations:
     // 8KB (8192 bytes): A common default that works well for most HTTP servers
     // 4KB (4096 bytes): Minimum reasonable size for most HTTP operations
@@ -81,27 +99,64 @@ class Connection {
     EventPoller& poller_;  // Reference to the event poller
 
     // Connection state
-    time_t last_activity_;  // Timestamp of last activity
-    bool should_close_;     // Flag indicating if connection should be closed
-    size_t request_count_;  // Number of requests processed on this connection
+    long last_activity_ms_;  // Monotonic timestamp of last activity (Clock::now_ms)
+    bool should_close_;      // Flag indicating if connection should be closed
+    size_t request_count_;   // Number of requests processed on this connection
 
     // Request/response state
-    std::string response_buffer_;  // Buffer for outgoing response data
+    RecvBuffer recv_buffer_;       // Received bytes not yet consumed by the parser
+    OutputQueue output_;           // Outgoing response segments, sent in order
+    bool body_waiting_;            // Front body source would block, its wait fd is watched
+    off_t body_produced_;          // Bytes pulled from the front body source so far
     HttpRequest current_request_;  // Current HTTP request being processed
     bool request_in_progress_;     // Flag indicating if a request is being processed
+    bool request_routed_;          // Current request has its route (headers parsed)
 
     // Configuration
-    const ServerBlock* server_block_;  // Server configuration for this connection
+    int local_port_;                     // Port the connection was accepted on
+    const VirtualHosts* virtual_hosts_;  // Server blocks of that port, by name
+    const ServerBlock* server_block_;    // Server configuration for the current request
+
+    // Event notification mode
+    bool edge_triggered_;  // Socket is watched edge-triggered and must be drained
 
     // CGI management
     CgiManager cgi_manager_;  // Manages CGI processes for this connection
 
+    void process_received_data();
+    void route_request();
+    void admit_request_body();
+    void resume_requests();
     void handle_http_request();
+    void finish_response(HttpResponse& response);
     void send_timeout_response();
+
+    // Response output (header block and body segments, sources streamed in place)
+    void queue_response(HttpResponse& response);
+    ssize_t send_output();
+    void pull_body_data();
+    ssize_t send_body_direct();
+    void finish_body();
+    void wait_for_body_source();
+    void clear_output();
+    void log_output_stats() const;
+    bool has_pending_output() const {
+        return !output_.empty();
+    }
+    bool wants_write() const {
+        return !output_.empty() && !body_waiting_;
+    }
+    bool output_backlogged() const {
+        return output_.get_buffered() >= MAX_QUEUED_OUTPUT ||
+               output_.get_source_count() >= MAX_QUEUED_SOURCES;
+    }
+    bool wants_read() const;
+    short wanted_events() const;
     void handle_http_error(const HttpError& error);
     void select_server_block_for_request();
 
     void update_activity_time();
+    void schedule_idle_timer();
     void update_events(short events);
 
     // Prevent copying
@@ -1,108 +1,261 @@
 #include "EventPoller.hpp"
 
-#include <cerrno>
+#include <unistd.h>
+
 #include <stdexcept>
 
-EventPoller::EventPoller() {
+#include "../utils/Clock.hpp"
+
+EventPoller::EventPoller() : backend_(POLL), edge_triggered_(false), watched_count_(0) {
+#ifdef __linux__
+    epoll_fd_ = -1;
+    uring_ = NULL;
+#endif
 }
 
 EventPoller::~EventPoller() {
+#ifdef __linux__
+    epoll_close();
+    uring_close();
+#endif
+    for (size_t i = 0; i < deferred_accepts_.size(); ++i) {
+        close(deferred_accepts_[i].second);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Backend selection
+// ----------------------------------------------------------------------------
+
+void EventPoller::configure(Backend backend, bool edge_triggered) {
+    if (watched_count_ != 0) {
+        throw std::runtime_error("Cannot change event backend while file descriptors are watched");
+    }
+
+#ifdef __linux__
+    epoll_close();
+    uring_close();
+    if (backend == EPOLL) {
+        epoll_open();
+    } else if (backend == IO_URING && !uring_open()) {
+        // Ring could not be created (old kernel, seccomp, memlock limit...)
+        backend = POLL;
+    }
+#else
+    // epoll and io_uring only exist on Linux, fall back to the portable backend
+    backend = POLL;
+#endif
+
+    backend_ = backend;
+    edge_triggered_ = (backend == EPOLL) && edge_triggered;
+}
+
+EventPoller::Backend EventPoller::backend_from_string(const std::string& name) {
+    if (name == "epoll") {
+        return EPOLL;
+    }
+    if (name == "io_uring") {
+        return IO_URING;
+    }
+    if (name == "poll") {
+        return POLL;
+    }
+    throw std::runtime_error("Unknown event backend: " + name);
+}
+
+std::string EventPoller::backend_to_string(Backend backend) {
+    switch (backend) {
+        case EPOLL:
+            return "epoll";
+        case IO_URING:
+            return "io_uring";
+        case POLL:
+            return "poll";
+        default:
+            return "unknown";
+    }
 }
 
 // ----------------------------------------------------------------------------
 // File descriptor management
 // ----------------------------------------------------------------------------
 
-void EventPoller::watch_fd(int fd, short events) {
+void EventPoller::watch_fd(int fd, short events, const FdOwner& owner) {
+    if (fd < 0) {
+        throw std::runtime_error("Invalid file descriptor");
+    }
+    if (static_cast<size_t>(fd) >= slots_.size()) {
+        slots_.resize(fd + 1);
+    }
+
     // Check if fd already exists
-    if (fd_events_.find(fd) != fd_events_.end()) {
+    FdSlot& slot = slots_[fd];
+    if (slot.watched) {
         throw std::runtime_error("File descriptor already being monitored");
     }
 
-    // Add to our tracking containers
-    struct pollfd pfd;
-    pfd.fd = fd;
-    pfd.events = events;
-    pfd.revents = 0;
+    // Known before the backend registers fd: io_uring picks the operation from the owner
+    slot.owner = owner;
 
-    poll_fds_.push_back(pfd);
-    fd_events_[fd] = events;
+#ifdef __linux__
+    if (backend_ == EPOLL) {
+        epoll_watch_fd(fd, events);
+    } else if (backend_ == IO_URING) {
+        uring_watch_fd(fd, events);
+    } else {
+        poll_watch_fd(fd, events);
+    }
+#else
+    poll_watch_fd(fd, events);
+#endif
+    slot.watched = true;
+    slot.events = events;
+    watched_count_++;
 }
 
 void EventPoller::update_events(int fd, short events) {
-    // Find and modify the fd's events
-    for (size_t i = 0; i < poll_fds_.size(); ++i) {
-        if (poll_fds_[i].fd == fd) {
-            poll_fds_[i].events = events;
-            fd_events_[fd] = events;
-            return;
-        }
+    FdSlot* slot = find_slot(fd);
+    if (!slot) {
+        throw std::runtime_error("File descriptor not found");
+    }
+
+    // Nothing to do when the interest set is unchanged
+    if (slot->events == events) {
+        return;
     }
-    throw std::runtime_error("File descriptor not found");
+
+#ifdef __linux__
+    if (backend_ == EPOLL) {
+        epoll_update_events(fd, events);
+    } else if (backend_ == IO_URING) {
+        uring_update_events(fd, events);
+    } else {
+        poll_update_events(fd, events);
+    }
+#else
+    poll_update_events(fd, events);
+#endif
+    slot->events = events;
 }
 
 void EventPoller::unwatch_fd(int fd) {
-    // Remove from vector
-    for (PollFdVectorIt it = poll_fds_.begin(); it != poll_fds_.end();) {
-        if (it->fd == fd) {
-            it = poll_fds_.erase(it);
+    timers_.cancel_all(fd);
+    FdSlot* slot = find_slot(fd);
+    if (!slot) {
+        return;
+    }
+
+#ifdef __linux__
+    if (backend_ == EPOLL) {
+        epoll_unwatch_fd(fd);
+    } else if (backend_ == IO_URING) {
+        uring_unwatch_fd(fd);
+    } else {
+        poll_unwatch_fd(fd);
+    }
+#else
+    poll_unwatch_fd(fd);
+#endif
+    *slot = FdSlot();
+    watched_count_--;
+}
+
+const FdOwner& EventPoller::get_owner(int fd) const {
+    static const FdOwner none;
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || !slots_[fd].watched) {
+        return none;
+    }
+    return slots_[fd].owner;
+}
+
+void EventPoller::defer_accepted(int listen_fd, int client_fd) {
+    deferred_accepts_.push_back(std::make_pair(listen_fd, client_fd));
+}
+
+void EventPoller::collect_deferred_accepts(PollResultVector& results) {
+    size_t kept = 0;
+    for (size_t i = 0; i < deferred_accepts_.size(); ++i) {
+        const FdSlot* slot = find_slot(deferred_accepts_[i].first);
+        if (slot && slot->owner.type == FdOwner::LISTENER) {
+            PollResult result;
+            result.fd = deferred_accepts_[i].first;
+            result.accepted_fd = deferred_accepts_[i].second;
+            results.push_back(result);
         } else {
-            ++it;
+            deferred_accepts_[kept++] = deferred_accepts_[i];
         }
     }
+    deferred_accepts_.resize(kept);
+}
 
-    // Remove from map
-    fd_events_.erase(fd);
+EventPoller::FdSlot* EventPoller::find_slot(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || !slots_[fd].watched) {
+        return NULL;
+    }
+    return &slots_[fd];
 }
 
 // ----------------------------------------------------------------------------
-// Poll for events and return results
+// Deadlines
 // ----------------------------------------------------------------------------
 
-std::vector<PollResult> EventPoller::poll_once() {
-    std::vector<PollResult> results;
+void EventPoller::set_timer(int fd, Timers::Type type, long deadline_ms) {
+    timers_.schedule(fd, type, deadline_ms);
+}
+
+void EventPoller::cancel_timer(int fd, Timers::Type type) {
+    timers_.cancel(fd, type);
+}
 
-    // If no fds to monitor, return empty results
-    if (poll_fds_.empty()) {
-        return results;
+void EventPoller::collect_expired_timers(PollResultVector& results) {
+    int fd;
+    Timers::Type type;
+    while (timers_.pop_expired(Clock::now_ms(), fd, type)) {
+        PollResult result;
+        result.fd = fd;
+        result.timer = type;
+        results.push_back(result);
     }
+}
 
-    // Wait for events
-    int ready = poll(&poll_fds_[0], poll_fds_.size(), POLL_TIMEOUT_MS);
+// ----------------------------------------------------------------------------
+// Poll for events and return results
+// ----------------------------------------------------------------------------
 
-    if (ready < 0) {
-        if (errno == EINTR) {
-            // Interrupted by signal, return empty results
-            return results;
-        }
-        throw std::runtime_error("Poll failed");
-    }
+std::vector<PollResult> EventPoller::poll_once(int max_timeout_ms) {
+    std::vector<PollResult> results;
 
-    if (ready == 0) {
-        // Timeout, return empty results
-        return results;
+    // Connections accepted while their listener was paused come first, without sleeping
+    collect_deferred_accepts(results);
+    if (!results.empty()) {
+        max_timeout_ms = 0;
     }
 
-    // Process all ready file descriptors
-    for (size_t i = 0; i < poll_fds_.size() && ready > 0; ++i) {
-        if (poll_fds_[i].revents != 0) {
-            results.push_back(create_poll_result(poll_fds_[i]));
-            ready--;
+    // Sleep no longer than the nearest deadline
+    int timeout_ms = timers_.next_timeout_ms(Clock::update(), max_timeout_ms);
+
+    // If no fds to monitor (e.g. paused listeners), only deadlines can fire
+    PollResultVector ready;
+    if (watched_count_ == 0) {
+        poll(NULL, 0, timeout_ms);
+    } else {
+#ifdef __linux__
+        if (backend_ == EPOLL) {
+            ready = epoll_wait_events(timeout_ms);
+        } else if (backend_ == IO_URING) {
+            ready = uring_wait_events(timeout_ms);
+        } else {
+            ready = poll_wait(timeout_ms);
         }
+#else
+        ready = poll_wait(timeout_ms);
+#endif
     }
+    results.insert(results.end(), ready.begin(), ready.end());
 
-    return results;
-}
+    // Refresh the cached clock once per wakeup, then report expired deadlines
+    Clock::update();
+    collect_expired_timers(results);
 
-PollResult EventPoller::create_poll_result(const struct pollfd& pfd) {
-    PollResult result;
-    result.fd = pfd.fd;
-
-    // Check for each type of event separately
-    result.can_read = (pfd.revents & PollEvents::READ) != 0;
-    result.can_write = (pfd.revents & PollEvents::WRITE) != 0;
-    result.has_error = (pfd.revents & PollEvents::ERROR) != 0;
-    result.has_hup = (pfd.revents & PollEvents::HUP) != 0;
-
-    return result;
+    return results;
 }
@@ -4,9 +4,19 @@
 #include <poll.h>
 
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "../utils/Types.hpp"
+#include "TimerQueue.hpp"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+#endif
 
 // Structure to hold poll results
 struct PollEvents {
@@ -14,41 +24,199 @@ struct PollEvents {
     static const short WRITE = POLLOUT;             // Buffer space available for writing
     static const short ERROR = POLLERR | POLLNVAL;  // Real errors only
     static const short HUP = POLLHUP;               // Peer closed their end
+    static const short EDGE = 0x4000;               // Edge-triggered request (epoll only)
 };
 
-struct PollResult {
-    int fd;          // File descriptor that had an event
-    bool can_read;   // True if fd is ready for reading
-    bool can_write;  // True if fd is ready for writing
-    bool has_error;  // True if fd has an error condition
-    bool has_hup;    // True if peer closed their end (POLLHUP)
+// Who a watched file descriptor belongs to, used by Server to dispatch events
+struct FdOwner {
+    enum Type {
+        NONE = 0,    // Not watched
+        LISTENER,    // Listening socket, object is the Socket
+        CLIENT,      // Client socket, object is the Connection
+        CGI_STDOUT,  // CGI output pipe, object is the Connection running the CGI
+        CGI_STDIN,   // CGI input pipe, object is the Connection running the CGI
+        WAKEUP,      // Cross-thread wakeup fd, object is the Reactor
+        BODY_SOURCE  // Response body producer the Connection waits on, object is the Connection
+    };
 
-    PollResult() : fd(-1), can_read(false), can_write(false), has_error(false), has_hup(false) {
+    Type type;
+    void* object;
+
+    FdOwner() : type(NONE), object(NULL) {
+    }
+    FdOwner(Type owner_type, void* owner_object) : type(owner_type), object(owner_object) {
     }
 };
 
-class EventPoller {
-   private:
-    std::vector<struct pollfd> poll_fds_;  // List of file descriptors to monitor
-    EventMap fd_events_;                   // Maps fd to its desired events
+struct PollResult {
+    int fd;              // File descriptor that had an event
+    bool can_read;       // True if fd is ready for reading
+    bool can_write;      // True if fd is ready for writing
+    bool has_error;      // True if fd has an error condition
+    bool has_hup;        // True if peer closed their end (POLLHUP)
+    Timers::Type timer;  // Expired deadline of fd, NONE for I/O events
 
-    // Poll timeout constants
-    static const int POLL_TIMEOUT_MS = 1000;  // Poll timeout in milliseconds (1 second)
+    // Completed I/O (io_uring backend): the kernel already did the accept() or recv()
+    int accepted_fd;     // Connection accepted on listener fd, -1 if none
+    bool received;       // Bytes were received on client fd
+    const char* data;    // Received bytes, valid until the next wait
+    size_t data_length;  // Number of received bytes, 0 when the peer closed
 
+    PollResult()
+        : fd(-1),
+          can_read(false),
+          can_write(false),
+          has_error(false),
+          has_hup(false),
+          timer(Timers::NONE),
+          accepted_fd(-1),
+          received(false),
+          data(NULL),
+          data_length(0) {
+    }
+};
+
+/**
+ * Readiness notification over a set of file descriptors.
+ *
+ * Interchangeable backends sit behind the same interface:
+ * - poll(): portable, O(n) per wakeup (kept for comparison)
+ * - epoll: Linux only, O(1) updates and O(ready) wakeups, optional edge-triggered mode
+ * - io_uring: Linux only, completion-based for listeners and client sockets: a multishot
+ *   accept hands over new connections and recv lands client bytes in a provided buffer
+ *   ring, so neither needs its own syscall. Other fds are polled. Every submission is
+ *   flushed together with the wait, so one syscall per loop iteration
+ *
+ * Edge-triggered notification is requested per fd by adding PollEvents::EDGE to its events.
+ * Owners of such fds must drain them until the syscall would block.
+ *
+ * Every watched fd is recorded in a flat fd-indexed registry together with its owner, so
+ * looking up the events, the owner or the backend slot of an fd is a vector index.
+ *
+ * The poller also owns the per-fd deadlines: the wait timeout is derived from the nearest
+ * one and expired deadlines are reported as PollResults with `timer` set. The cached
+ * Clock is refreshed after every wait.
+ */
+class EventPoller {
    public:
+    enum Backend { POLL, EPOLL, IO_URING };
+
     EventPoller();
     ~EventPoller();
 
+    // Select the backend and mode, only allowed while no fd is being monitored
+    void configure(Backend backend, bool edge_triggered);
+    Backend get_backend() const {
+        return backend_;
+    }
+    bool is_edge_triggered() const {
+        return edge_triggered_;
+    }
+    static Backend backend_from_string(const std::string& name);
+    static std::string backend_to_string(Backend backend);
+
     // File descriptor management
-    void watch_fd(int fd, short events);       // Add fd to monitoring
-    void update_events(int fd, short events);  // Modify events for fd
-    void unwatch_fd(int fd);                   // Remove fd from monitoring
+    void watch_fd(int fd, short events, const FdOwner& owner);  // Add fd to monitoring
+    void update_events(int fd, short events);                   // Modify events for fd
+    void unwatch_fd(int fd);                                    // Remove fd and its timers
+
+    // Current owner of fd, NONE if it is not watched (anymore)
+    const FdOwner& get_owner(int fd) const;
 
-    // Poll for events and return results
-    PollResultVector poll_once();  // Do one poll() and return results
+    // Connection accepted by the poller (PollResult::accepted_fd) that cannot be admitted
+    // yet: reported again once listen_fd is watched, closed with the poller otherwise
+    void defer_accepted(int listen_fd, int client_fd);
+
+    // Deadlines (monotonic milliseconds, see Clock::now_ms)
+    void set_timer(int fd, Timers::Type type, long deadline_ms);
+    void cancel_timer(int fd, Timers::Type type);
+
+    // Poll timeout constants
+    static const int POLL_TIMEOUT_MS = 1000;  // Longest wait without any deadline (1 second)
+
+    // Wait once (at most max_timeout_ms) and return results
+    PollResultVector poll_once(int max_timeout_ms = POLL_TIMEOUT_MS);
 
    private:
+
+    // Registry entry of a file descriptor
+    struct FdSlot {
+        bool watched;       // fd is currently monitored
+        short events;       // Desired events
+        FdOwner owner;      // Object to dispatch events to
+        size_t poll_index;  // Position in poll_fds_ (poll backend only)
+
+        FdSlot() : watched(false), events(0), poll_index(0) {
+        }
+    };
+
+    Backend backend_;            // Active readiness backend
+    bool edge_triggered_;        // Whether client sockets use edge-triggered notification
+    std::vector<FdSlot> slots_;  // Registry indexed by fd
+    size_t watched_count_;       // Number of watched fds
+    TimerQueue timers_;          // Per-fd deadlines
+
+    // Accepted while their listener was unwatched, (listener fd, client fd)
+    std::vector<std::pair<int, int> > deferred_accepts_;
+
+    FdSlot* find_slot(int fd);
+
+    void collect_expired_timers(PollResultVector& results);
+    void collect_deferred_accepts(PollResultVector& results);
+
+    // poll() backend state (EventPoller_poll.cpp)
+    std::vector<struct pollfd> poll_fds_;  // List of file descriptors to monitor
+
+    void poll_watch_fd(int fd, short events);
+    void poll_update_events(int fd, short events);
+    void poll_unwatch_fd(int fd);
+    PollResultVector poll_wait(int timeout_ms);
     PollResult create_poll_result(const struct pollfd& pfd);
+
+#ifdef __linux__
+    // epoll backend state (EventPoller_epoll.cpp)
+    static const size_t MIN_EPOLL_EVENTS = 64;    // Smallest epoll_wait() batch
+    static const size_t MAX_EPOLL_EVENTS = 4096;  // Largest epoll_wait() batch
+
+    int epoll_fd_;                                  // epoll instance
+    std::vector<struct epoll_event> epoll_events_;  // epoll_wait() output buffer
+
+    void epoll_open();
+    void epoll_close();
+    void epoll_watch_fd(int fd, short events);
+    void epoll_update_events(int fd, short events);
+    void epoll_unwatch_fd(int fd);
+    PollResultVector epoll_wait_events(int timeout_ms);
+    static unsigned int to_epoll_events(short events);
+    static PollResult create_epoll_result(const struct epoll_event& event);
+
+    // io_uring backend state (EventPoller_uring.cpp)
+    struct UringRing;   // Mapped submission/completion rings
+    UringRing* uring_;  // NULL unless the io_uring backend is active
+
+    bool uring_open();
+    void uring_close();
+    void uring_watch_fd(int fd, short events);
+    void uring_update_events(int fd, short events);
+    void uring_unwatch_fd(int fd);
+    PollResultVector uring_wait_events(int timeout_ms);
+    struct io_uring_sqe* uring_next_sqe();
+    void uring_arm(int fd, short events);
+    void uring_arm_poll(int fd, short events);
+    void uring_cancel_poll(int fd);
+    bool uring_completes_input(int fd) const;
+    void uring_arm_input(int fd);
+    void uring_cancel_input(int fd);
+    bool uring_complete_input(const struct io_uring_cqe& cqe, PollResult& result);
+    bool uring_setup_buffers();
+    void uring_provide_buffer(unsigned short id);
+    void uring_recycle_buffers();
+    void uring_submit_pending();
+#endif
+
+    // Prevent copying
+    EventPoller(const EventPoller&);
+    EventPoller& operator=(const EventPoller&);
 };
 
 #endif  // EVENTPOLLER_HPP
@@ -0,0 +1,124 @@
+#ifdef __linux__
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "EventPoller.hpp"
+
+const size_t EventPoller::MIN_EPOLL_EVENTS;
+const size_t EventPoller::MAX_EPOLL_EVENTS;
+
+// ----------------------------------------------------------------------------
+// epoll backend
+// ----------------------------------------------------------------------------
+
+void EventPoller::epoll_open() {
+    // Atomic FD_CLOEXEC: another reactor thread may fork a CGI before an fcntl() would run
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+    epoll_events_.resize(MIN_EPOLL_EVENTS);
+}
+
+void EventPoller::epoll_close() {
+    if (epoll_fd_ != -1) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+void EventPoller::epoll_watch_fd(int fd, short events) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = to_epoll_events(events);
+    event.data.fd = fd;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+}
+
+void EventPoller::epoll_update_events(int fd, short events) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = to_epoll_events(events);
+    event.data.fd = fd;
+
+    // EPOLL_CTL_MOD also re-arms edge-triggered fds that are still ready
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) == -1) {
+        throw std::runtime_error("Failed to modify file descriptor in epoll");
+    }
+}
+
+void EventPoller::epoll_unwatch_fd(int fd) {
+    // A closed fd has already left the interest list, so failure is not an error here
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+}
+
+std::vector<PollResult> EventPoller::epoll_wait_events(int timeout_ms) {
+    std::vector<PollResult> results;
+
+    // Grow the output buffer with the number of watched fds so one call can drain a burst
+    size_t wanted = std::min(std::max(watched_count_, MIN_EPOLL_EVENTS), MAX_EPOLL_EVENTS);
+    if (epoll_events_.size() < wanted) {
+        epoll_events_.resize(wanted);
+    }
+
+    int ready = epoll_wait(epoll_fd_, &epoll_events_[0], epoll_events_.size(), timeout_ms);
+
+    if (ready < 0) {
+        if (errno == EINTR) {
+            // Interrupted by signal, return empty results
+            return results;
+        }
+        throw std::runtime_error("epoll_wait failed");
+    }
+
+    // Only ready file descriptors are reported, no scan over the watched set
+    results.reserve(ready);
+    for (int i = 0; i < ready; ++i) {
+        results.push_back(create_epoll_result(epoll_events_[i]));
+    }
+
+    return results;
+}
+
+unsigned int EventPoller::to_epoll_events(short events) {
+    unsigned int epoll_events = 0;
+
+    if (events & POLLIN) {
+        epoll_events |= EPOLLIN;
+    }
+    if (events & POLLPRI) {
+        epoll_events |= EPOLLPRI;
+    }
+    if (events & POLLOUT) {
+        epoll_events |= EPOLLOUT;
+    }
+    if (events & PollEvents::EDGE) {
+        epoll_events |= EPOLLET;
+    }
+
+    return epoll_events;
+}
+
+PollResult EventPoller::create_epoll_result(const struct epoll_event& event) {
+    PollResult result;
+    result.fd = event.data.fd;
+
+    result.can_read = (event.events & (EPOLLIN | EPOLLPRI)) != 0;
+    result.can_write = (event.events & EPOLLOUT) != 0;
+    result.has_error = (event.events & EPOLLERR) != 0;
+    result.has_hup = (event.events & EPOLLHUP) != 0;
+
+    return result;
+}
+
+#endif  // __linux__
@@ -0,0 +1,77 @@
+#include <cerrno>
+#include <stdexcept>
+
+#include "EventPoller.hpp"
+
+// ----------------------------------------------------------------------------
+// poll() backend
+// ----------------------------------------------------------------------------
+
+void EventPoller::poll_watch_fd(int fd, short events) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = events & ~PollEvents::EDGE;
+    pfd.revents = 0;
+
+    slots_[fd].poll_index = poll_fds_.size();
+    poll_fds_.push_back(pfd);
+}
+
+void EventPoller::poll_update_events(int fd, short events) {
+    // The registry remembers where the fd sits in the pollfd array
+    poll_fds_[slots_[fd].poll_index].events = events & ~PollEvents::EDGE;
+}
+
+void EventPoller::poll_unwatch_fd(int fd) {
+    // Move the last entry into the freed position instead of shifting the array
+    size_t index = slots_[fd].poll_index;
+    size_t last = poll_fds_.size() - 1;
+    if (index != last) {
+        poll_fds_[index] = poll_fds_[last];
+        slots_[poll_fds_[index].fd].poll_index = index;
+    }
+    poll_fds_.pop_back();
+}
+
+std::vector<PollResult> EventPoller::poll_wait(int timeout_ms) {
+    std::vector<PollResult> results;
+
+    // Wait for events
+    int ready = poll(&poll_fds_[0], poll_fds_.size(), timeout_ms);
+
+    if (ready < 0) {
+        if (errno == EINTR) {
+            // Interrupted by signal, return empty results
+            return results;
+        }
+        throw std::runtime_error("Poll failed");
+    }
+
+    if (ready == 0) {
+        // Timeout, return empty results
+        return results;
+    }
+
+    // Process all ready file descriptors
+    for (size_t i = 0; i < poll_fds_.size() && ready > 0; ++i) {
+        if (poll_fds_[i].revents != 0) {
+            results.push_back(create_poll_result(poll_fds_[i]));
+            ready--;
+        }
+    }
+
+    return results;
+}
+
+PollResult EventPoller::create_poll_result(const struct pollfd& pfd) {
+    PollResult result;
+    result.fd = pfd.fd;
+
+    // Check for each type of event separately
+    result.can_read = (pfd.revents & PollEvents::READ) != 0;
+    result.can_write = (pfd.revents & PollEvents::WRITE) != 0;
+    result.has_error = (pfd.revents & PollEvents::ERROR) != 0;
+    result.has_hup = (pfd.revents & PollEvents::HUP) != 0;
+
+    return result;
+}
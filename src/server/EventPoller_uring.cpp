@@ -0,0 +1,570 @@
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "EventPoller.hpp"
+
+// ----------------------------------------------------------------------------
+// io_uring backend
+//
+// Input on listeners and client sockets completes in the kernel:
+// - a listener wanting READ has a multishot IORING_OP_ACCEPT, one completion per new
+//   connection, and the accepted fd is reported in PollResult::accepted_fd
+// - a client socket wanting READ has an IORING_OP_RECV that picks a buffer from the
+//   provided buffer ring, and the bytes are reported in PollResult::data
+// A recv is re-armed after each completion while READ is still wanted, so a connection
+// that pauses reading gets at most the one completion already in flight. When the ring
+// runs out of buffers the recv fails with ENOBUFS and is reported as plain readiness, the
+// connection then reads by itself.
+//
+// Everything else (WRITE interest, pipes, eventfds) uses one-shot IORING_OP_POLL_ADD
+// entries. A one-shot poll completes immediately when the fd is already ready, so
+// re-arming every fired fd before the next wait gives the same level-triggered behavior
+// as poll()/epoll.
+//
+// Arming, re-arming and cancelling only write submission entries; they reach the kernel
+// together with the wait in a single io_uring_enter() per loop iteration. Kernels without
+// provided buffer rings (before 5.19) get polls for everything.
+// ----------------------------------------------------------------------------
+
+// Ring configuration constants
+static const unsigned URING_ENTRIES = 256;             // Submission queue size
+static const __u64 URING_NO_EVENT = 0;                 // user_data of entries without a result
+static const unsigned URING_RECV_BUFFERS = 128;        // Provided buffers (power of two)
+static const unsigned URING_RECV_BUFFER_SIZE = 16384;  // Bytes per provided buffer
+static const __u16 URING_BUFFER_GROUP = 0;             // Buffer group of the provided ring
+
+// Kind of operation a tag refers to
+enum UringOp { URING_POLL = 0, URING_ACCEPT = 1, URING_RECV = 2 };
+
+// Accept or recv in flight for an fd
+struct UringInput {
+    __u64 tag;        // Tag of the operation, 0 when none is in flight
+    bool cancelling;  // Cancel submitted, a racing completion is still delivered
+
+    UringInput() : tag(0), cancelling(false) {
+    }
+};
+
+struct EventPoller::UringRing {
+    int fd;  // io_uring instance (created O_CLOEXEC by the kernel)
+
+    // Submission ring
+    void* sq_ring;
+    size_t sq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned sq_entries;
+    unsigned sq_local_tail;  // Next free entry, published to sq_tail before io_uring_enter()
+
+    // Completion ring (shares the submission ring mapping)
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+
+    // Registrations
+    __u64 next_sequence;               // Makes every tag unique
+    std::map<int, __u64> poll_tags;    // fd -> tag of its armed poll, 0 when fired
+    std::map<int, UringInput> inputs;  // fd -> its accept or recv
+    std::vector<int> fired_fds;        // Fds to re-arm before the next wait
+
+    // Provided buffer ring, recv completions pick their buffer from it
+    struct io_uring_buf* buffers;     // Ring entries, NULL when not registered
+    size_t buffers_size;              // Size of the ring mapping
+    char* buffer_memory;              // URING_RECV_BUFFERS buffers back to back
+    __u16 buffer_tail;                // Next free ring entry, published to the kernel
+    std::vector<__u16> used_buffers;  // Handed out by the last wait, provided again next
+
+    UringRing()
+        : fd(-1),
+          sq_ring(MAP_FAILED),
+          sq_ring_size(0),
+          sqes(NULL),
+          sqes_size(0),
+          sq_head(NULL),
+          sq_tail(NULL),
+          sq_mask(NULL),
+          sq_array(NULL),
+          sq_entries(0),
+          sq_local_tail(0),
+          cq_head(NULL),
+          cq_tail(NULL),
+          cq_mask(NULL),
+          cqes(NULL),
+          next_sequence(1),
+          buffers(NULL),
+          buffers_size(0),
+          buffer_memory(NULL),
+          buffer_tail(0) {
+    }
+};
+
+static int io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(
+    int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg,
+    size_t arg_size) {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+static int io_uring_register(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// A tag carries the fd in its low half, the operation in the next two bits and a sequence
+// number above, so completions of cancelled operations can never be mistaken for the
+// current one
+static __u64 make_tag(__u64 sequence, UringOp op, int fd) {
+    return (sequence << 34) | (static_cast<__u64>(op) << 32) | static_cast<unsigned int>(fd);
+}
+
+static int tag_fd(__u64 tag) {
+    return static_cast<int>(tag & 0xffffffffU);
+}
+
+static UringOp tag_op(__u64 tag) {
+    return static_cast<UringOp>((tag >> 32) & 3);
+}
+
+bool EventPoller::uring_open() {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int ring_fd = io_uring_setup(URING_ENTRIES, &params);
+    if (ring_fd < 0) {
+        return false;
+    }
+
+    // Timed waits need EXT_ARG; NODROP keeps completions when the CQ ring overflows
+    unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        close(ring_fd);
+        return false;
+    }
+
+    UringRing* ring = new UringRing();
+    ring->fd = ring_fd;
+
+    // With SINGLE_MMAP both rings live in one mapping large enough for either
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sq_ring_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->sq_ring = mmap(
+        NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+        IORING_OFF_SQ_RING);
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = MAP_FAILED;
+    if (ring->sq_ring != MAP_FAILED) {
+        sqes = mmap(
+            NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+            IORING_OFF_SQES);
+    }
+
+    if (sqes == MAP_FAILED) {
+        uring_ = ring;
+        uring_close();
+        return false;
+    }
+
+    char* base = static_cast<char*>(ring->sq_ring);
+    ring->sqes = static_cast<struct io_uring_sqe*>(sqes);
+    ring->sq_head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    ring->sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_local_tail = *ring->sq_tail;
+    ring->cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<struct io_uring_cqe*>(base + params.cq_off.cqes);
+
+    uring_ = ring;
+
+    // Without provided buffer rings, listeners and client sockets are polled as well
+    uring_setup_buffers();
+    return true;
+}
+
+// Register the provided buffer ring and hand every buffer to the kernel
+bool EventPoller::uring_setup_buffers() {
+    size_t ring_size = URING_RECV_BUFFERS * sizeof(struct io_uring_buf);
+    void* ring = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<__u64>(ring);
+    reg.ring_entries = URING_RECV_BUFFERS;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (io_uring_register(uring_->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        munmap(ring, ring_size);
+        return false;
+    }
+
+    uring_->buffers = static_cast<struct io_uring_buf*>(ring);
+    uring_->buffers_size = ring_size;
+    uring_->buffer_memory = new char[URING_RECV_BUFFERS * URING_RECV_BUFFER_SIZE];
+    for (unsigned id = 0; id < URING_RECV_BUFFERS; ++id) {
+        uring_provide_buffer(static_cast<unsigned short>(id));
+    }
+    // The ring tail overlays the reserved field of the first entry
+    __atomic_store_n(&uring_->buffers[0].resv, uring_->buffer_tail, __ATOMIC_RELEASE);
+    return true;
+}
+
+void EventPoller::uring_provide_buffer(unsigned short id) {
+    struct io_uring_buf& entry = uring_->buffers[uring_->buffer_tail & (URING_RECV_BUFFERS - 1)];
+    entry.addr = reinterpret_cast<__u64>(uring_->buffer_memory + id * URING_RECV_BUFFER_SIZE);
+    entry.len = URING_RECV_BUFFER_SIZE;
+    entry.bid = id;
+    uring_->buffer_tail++;
+}
+
+// Buffers of the previous results are no longer read, give them back to the kernel
+void EventPoller::uring_recycle_buffers() {
+    if (uring_->used_buffers.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < uring_->used_buffers.size(); ++i) {
+        uring_provide_buffer(uring_->used_buffers[i]);
+    }
+    uring_->used_buffers.clear();
+    __atomic_store_n(&uring_->buffers[0].resv, uring_->buffer_tail, __ATOMIC_RELEASE);
+}
+
+void EventPoller::uring_close() {
+    if (!uring_) {
+        return;
+    }
+
+    if (uring_->buffers) {
+        munmap(uring_->buffers, uring_->buffers_size);
+    }
+    delete[] uring_->buffer_memory;
+    if (uring_->sqes) {
+        munmap(uring_->sqes, uring_->sqes_size);
+    }
+    if (uring_->sq_ring != MAP_FAILED) {
+        munmap(uring_->sq_ring, uring_->sq_ring_size);
+    }
+    if (uring_->fd != -1) {
+        close(uring_->fd);
+    }
+
+    delete uring_;
+    uring_ = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Submission helpers
+// ----------------------------------------------------------------------------
+
+void EventPoller::uring_submit_pending() {
+    __atomic_store_n(uring_->sq_tail, uring_->sq_local_tail, __ATOMIC_RELEASE);
+
+    unsigned head = __atomic_load_n(uring_->sq_head, __ATOMIC_ACQUIRE);
+    while (uring_->sq_local_tail != head) {
+        int submitted = io_uring_enter(uring_->fd, uring_->sq_local_tail - head, 0, 0, NULL, 0);
+        if (submitted < 0 && errno != EINTR) {
+            throw std::runtime_error("io_uring_enter submit failed");
+        }
+        head = __atomic_load_n(uring_->sq_head, __ATOMIC_ACQUIRE);
+    }
+}
+
+struct io_uring_sqe* EventPoller::uring_next_sqe() {
+    // Flush the ring first if every submission entry is taken
+    unsigned head = __atomic_load_n(uring_->sq_head, __ATOMIC_ACQUIRE);
+    if (uring_->sq_local_tail - head >= uring_->sq_entries) {
+        uring_submit_pending();
+    }
+
+    unsigned index = uring_->sq_local_tail & *uring_->sq_mask;
+    struct io_uring_sqe* sqe = &uring_->sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    uring_->sq_array[index] = index;
+    uring_->sq_local_tail++;
+    return sqe;
+}
+
+// Arm what fd is missing for events: its accept or recv, and a poll for the rest
+void EventPoller::uring_arm(int fd, short events) {
+    events &= ~PollEvents::EDGE;
+
+    bool input_armed = false;
+    if ((events & PollEvents::READ) && uring_completes_input(fd)) {
+        uring_arm_input(fd);
+        events &= ~PollEvents::READ;
+        input_armed = true;
+    }
+
+    // Without any input operation, a poll still reports errors and hang-ups
+    std::map<int, __u64>::const_iterator it = uring_->poll_tags.find(fd);
+    bool poll_armed = it != uring_->poll_tags.end() && it->second != 0;
+    if (!poll_armed && (events != 0 || !input_armed)) {
+        uring_arm_poll(fd, events);
+    }
+}
+
+void EventPoller::uring_arm_poll(int fd, short events) {
+    __u64 tag = make_tag(uring_->next_sequence++, URING_POLL, fd);
+
+    struct io_uring_sqe* sqe = uring_next_sqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = static_cast<unsigned short>(events & ~PollEvents::EDGE);
+    sqe->user_data = tag;
+
+    uring_->poll_tags[fd] = tag;
+}
+
+void EventPoller::uring_cancel_poll(int fd) {
+    std::map<int, __u64>::iterator it = uring_->poll_tags.find(fd);
+    if (it == uring_->poll_tags.end() || it->second == 0) {
+        return;  // Nothing armed (already fired or never watched)
+    }
+
+    struct io_uring_sqe* sqe = uring_next_sqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = it->second;
+    sqe->user_data = URING_NO_EVENT;
+
+    it->second = 0;
+}
+
+// Listeners and client sockets complete their input in the kernel when buffers are provided
+bool EventPoller::uring_completes_input(int fd) const {
+    if (!uring_->buffers) {
+        return false;
+    }
+    FdOwner::Type type = slots_[fd].owner.type;
+    return type == FdOwner::LISTENER || type == FdOwner::CLIENT;
+}
+
+void EventPoller::uring_arm_input(int fd) {
+    UringInput& input = uring_->inputs[fd];
+    if (input.tag != 0) {
+        input.cancelling = false;  // Still in flight: re-armed after its completion
+        return;
+    }
+
+    struct io_uring_sqe* sqe = uring_next_sqe();
+    sqe->fd = fd;
+    if (slots_[fd].owner.type == FdOwner::LISTENER) {
+        // Stays armed across completions while they carry IORING_CQE_F_MORE
+        input.tag = make_tag(uring_->next_sequence++, URING_ACCEPT, fd);
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    } else {
+        input.tag = make_tag(uring_->next_sequence++, URING_RECV, fd);
+        sqe->opcode = IORING_OP_RECV;
+        sqe->len = URING_RECV_BUFFER_SIZE;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = URING_BUFFER_GROUP;
+    }
+    sqe->user_data = input.tag;
+    input.cancelling = false;
+}
+
+void EventPoller::uring_cancel_input(int fd) {
+    std::map<int, UringInput>::iterator it = uring_->inputs.find(fd);
+    if (it == uring_->inputs.end() || it->second.tag == 0 || it->second.cancelling) {
+        return;
+    }
+
+    struct io_uring_sqe* sqe = uring_next_sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = it->second.tag;
+    sqe->user_data = URING_NO_EVENT;
+
+    it->second.cancelling = true;
+}
+
+// ----------------------------------------------------------------------------
+// File descriptor management
+// ----------------------------------------------------------------------------
+
+void EventPoller::uring_watch_fd(int fd, short events) {
+    uring_arm(fd, events);
+}
+
+void EventPoller::uring_update_events(int fd, short events) {
+    // A one-shot poll cannot be modified in place: cancel it and arm a new one. An accept
+    // or recv stays in flight as long as READ is wanted.
+    uring_cancel_poll(fd);
+    if (!(events & PollEvents::READ)) {
+        uring_cancel_input(fd);
+    }
+    uring_arm(fd, events);
+}
+
+void EventPoller::uring_unwatch_fd(int fd) {
+    uring_cancel_poll(fd);
+    uring_->poll_tags.erase(fd);
+    uring_cancel_input(fd);
+    uring_->inputs.erase(fd);  // A completion still in flight is dropped
+}
+
+// ----------------------------------------------------------------------------
+// Wait for completions
+// ----------------------------------------------------------------------------
+
+std::vector<PollResult> EventPoller::uring_wait_events(int timeout_ms) {
+    std::vector<PollResult> results;
+
+    // The previous results have been handled: their buffers go back to the kernel, and
+    // fds whose operations completed are re-armed for what they still want
+    if (uring_->buffers) {
+        uring_recycle_buffers();
+    }
+    std::vector<int> fired;
+    fired.swap(uring_->fired_fds);
+    for (size_t i = 0; i < fired.size(); ++i) {
+        if (find_slot(fired[i])) {
+            uring_arm(fired[i], slots_[fired[i]].events);
+        }
+    }
+
+    // Submit every queued change and wait in the same syscall
+    __atomic_store_n(uring_->sq_tail, uring_->sq_local_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = uring_->sq_local_tail - __atomic_load_n(uring_->sq_head, __ATOMIC_ACQUIRE);
+
+    struct __kernel_timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+
+    struct io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    arg.ts = reinterpret_cast<__u64>(&timeout);
+
+    int ret = io_uring_enter(
+        uring_->fd, to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    if (ret < 0 && errno != EINTR && errno != ETIME) {
+        throw std::runtime_error("io_uring_enter wait failed");
+    }
+
+    // Reap completions
+    unsigned head = *uring_->cq_head;
+    unsigned tail = __atomic_load_n(uring_->cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe& cqe = uring_->cqes[head & *uring_->cq_mask];
+
+        // A provided buffer is given back before the next wait, whoever the completion is for
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            __u16 id = static_cast<__u16>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            uring_->used_buffers.push_back(id);
+        }
+        if (cqe.user_data == URING_NO_EVENT) {
+            continue;
+        }
+
+        if (tag_op(cqe.user_data) != URING_POLL) {
+            PollResult result;
+            if (uring_complete_input(cqe, result)) {
+                results.push_back(result);
+            }
+            continue;
+        }
+
+        // Ignore completions of polls that were cancelled or replaced since
+        int fd = tag_fd(cqe.user_data);
+        std::map<int, __u64>::iterator it = uring_->poll_tags.find(fd);
+        if (it == uring_->poll_tags.end() || it->second != cqe.user_data) {
+            continue;
+        }
+        it->second = 0;
+        uring_->fired_fds.push_back(fd);
+
+        PollResult result;
+        result.fd = fd;
+        if (cqe.res < 0) {
+            result.has_error = true;
+        } else {
+            result.can_read = (cqe.res & PollEvents::READ) != 0;
+            result.can_write = (cqe.res & PollEvents::WRITE) != 0;
+            result.has_error = (cqe.res & PollEvents::ERROR) != 0;
+            result.has_hup = (cqe.res & PollEvents::HUP) != 0;
+        }
+        results.push_back(result);
+    }
+
+    __atomic_store_n(uring_->cq_head, head, __ATOMIC_RELEASE);
+
+    return results;
+}
+
+// Result of an accept or recv completion, false when there is nothing to report
+bool EventPoller::uring_complete_input(const struct io_uring_cqe& cqe, PollResult& result) {
+    int fd = tag_fd(cqe.user_data);
+    UringOp op = tag_op(cqe.user_data);
+
+    // The fd was unwatched since. A multishot accept takes the whole backlog, so connections
+    // accepted after the listener paused wait until it is watched again.
+    std::map<int, UringInput>::iterator it = uring_->inputs.find(fd);
+    if (it == uring_->inputs.end() || it->second.tag != cqe.user_data) {
+        if (op == URING_ACCEPT && cqe.res >= 0) {
+            defer_accepted(fd, cqe.res);
+        }
+        return false;
+    }
+
+    // Done unless a multishot accept goes on, re-armed before the next wait if still wanted
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        it->second.tag = 0;
+        it->second.cancelling = false;
+        uring_->fired_fds.push_back(fd);
+    }
+
+    result.fd = fd;
+    if (cqe.res == -ECANCELED) {
+        return false;
+    }
+    if (op == URING_ACCEPT) {
+        if (cqe.res >= 0) {
+            result.accepted_fd = cqe.res;
+        } else {
+            result.can_read = true;  // Let the listener's own accept() report the failure
+        }
+    } else if (cqe.res >= 0) {
+        result.received = true;
+        result.data_length = static_cast<size_t>(cqe.res);
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            __u16 id = static_cast<__u16>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            result.data = uring_->buffer_memory + id * URING_RECV_BUFFER_SIZE;
+        }
+    } else if (cqe.res == -ENOBUFS) {
+        result.can_read = true;  // No provided buffer left, the connection reads by itself
+    } else {
+        result.has_error = true;
+    }
+    return true;
+}
+
+#endif  // __linux__
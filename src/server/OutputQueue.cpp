@@ -0,0 +1,121 @@
+#include "OutputQueue.hpp"
+
+#include <sys/uio.h>
+
+const int OutputQueue::MAX_IOVECS;
+
+OutputQueue::OutputQueue() : buffered_(0), source_count_(0) {
+}
+
+OutputQueue::~OutputQueue() {
+    clear();
+}
+
+void OutputQueue::push_back(std::string& data) {
+    if (data.empty()) {
+        return;
+    }
+    stats_.bytes_queued += data.size();
+    buffered_ += data.size();
+    segments_.push_back(Segment());
+    segments_.back().data.swap(data);
+}
+
+void OutputQueue::push_front(std::string& data, size_t offset) {
+    if (data.size() <= offset) {
+        return;
+    }
+    stats_.bytes_queued += data.size() - offset;
+    buffered_ += data.size() - offset;
+    segments_.push_front(Segment());
+    segments_.front().data.swap(data);
+    segments_.front().offset = offset;
+}
+
+void OutputQueue::push_source(BodySource* source, bool chunked) {
+    source->retain();
+    source_count_++;
+    segments_.push_back(Segment());
+    segments_.back().source = source;
+    segments_.back().chunked = chunked;
+}
+
+BodySource* OutputQueue::front_source() const {
+    return segments_.empty() ? NULL : segments_.front().source;
+}
+
+bool OutputQueue::front_chunked() const {
+    return !segments_.empty() && segments_.front().chunked;
+}
+
+void OutputQueue::pop_source() {
+    segments_.front().source->release();
+    segments_.pop_front();
+    source_count_--;
+    if (source_count_ == 0) {
+        std::string().swap(spare_);  // Idle connections hold no spare
+    }
+}
+
+void OutputQueue::clear() {
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (segments_[i].source) {
+            segments_[i].source->release();
+        }
+    }
+    segments_.clear();
+    std::string().swap(spare_);
+    buffered_ = 0;
+    source_count_ = 0;
+}
+
+ssize_t OutputQueue::write_to(int fd) {
+    struct iovec iov[MAX_IOVECS];
+    int count = 0;
+    for (size_t i = 0; i < segments_.size() && count < MAX_IOVECS; ++i) {
+        const Segment& segment = segments_[i];
+        if (segment.source) {
+            break;
+        }
+        iov[count].iov_base = const_cast<char*>(segment.data.data() + segment.offset);
+        iov[count].iov_len = segment.data.size() - segment.offset;
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    ssize_t bytes_sent = writev(fd, iov, count);
+    stats_.send_calls++;
+    if (bytes_sent <= 0) {
+        return bytes_sent;
+    }
+    stats_.bytes_sent += bytes_sent;
+    buffered_ -= bytes_sent;
+
+    // Drop the buffers sent in full, advance the offset of a partially sent one
+    size_t remaining = static_cast<size_t>(bytes_sent);
+    while (remaining > 0) {
+        Segment& segment = segments_.front();
+        size_t left = segment.data.size() - segment.offset;
+        if (remaining < left) {
+            segment.offset += remaining;
+            break;
+        }
+        remaining -= left;
+        if (source_count_ > 0 && segment.data.capacity() > spare_.capacity()) {
+            spare_.swap(segment.data);
+        }
+        segments_.pop_front();
+    }
+    return bytes_sent;
+}
+
+ssize_t OutputQueue::send_source_direct(int fd, size_t max_bytes) {
+    ssize_t bytes_sent = segments_.front().source->send_direct(fd, max_bytes);
+    stats_.send_calls++;
+    if (bytes_sent > 0) {
+        stats_.bytes_sent += bytes_sent;
+    }
+    return bytes_sent;
+}
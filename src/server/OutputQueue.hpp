@@ -0,0 +1,102 @@
+#ifndef OUTPUTQUEUE_HPP
+#define OUTPUTQUEUE_HPP
+
+#include <sys/types.h>
+
+#include <deque>
+#include <string>
+
+#include "../http/response/BodySource.hpp"
+
+/**
+ * Outgoing bytes of a connection, as a list of segments sent in order.
+ *
+ * A segment is either a buffer (header block, in-memory body, chunk framing) with the
+ * offset already sent, or a BodySource streamed in place. Buffers are swapped in, never
+ * copied, and partial sends only advance an offset. Consecutive buffers go out in one
+ * writev(), so headers and body leave together without being concatenated first.
+ *
+ * While a source is queued, the largest buffer sent in full is kept as a spare, so the
+ * pieces pulled from the source reuse one allocation instead of making one each.
+ */
+class OutputQueue {
+   public:
+    // Accounting of one burst of responses, reset by the Connection when the queue refills
+    struct Stats {
+        size_t bytes_queued;  // Bytes of buffer segments added
+        size_t bytes_sent;    // Bytes accepted by the socket (buffers and sources)
+        size_t send_calls;    // writev()/sendfile()/send() calls issued
+
+        Stats() : bytes_queued(0), bytes_sent(0), send_calls(0) {
+        }
+    };
+
+    OutputQueue();
+    ~OutputQueue();
+
+    // Buffers are taken over with swap(), data is left empty
+    void push_back(std::string& data);
+    // Ahead of everything, e.g. before a pulled source. The first offset bytes are not sent
+    void push_front(std::string& data, size_t offset = 0);
+
+    // Exchanges buffer with the spare: an empty string in gets the spare out, and a buffer
+    // in becomes the spare. Contents are left as they are, only the capacity matters
+    void swap_spare(std::string& buffer) {
+        spare_.swap(buffer);
+    }
+
+    // Streamed body, holds its own reference until popped
+    void push_source(BodySource* source, bool chunked);
+
+    bool empty() const {
+        return segments_.empty();
+    }
+    size_t get_buffered() const {
+        return buffered_;  // Unsent bytes of buffer segments
+    }
+    size_t get_source_count() const {
+        return source_count_;
+    }
+    BodySource* front_source() const;  // NULL unless the front segment is a source
+    bool front_chunked() const;        // Front source is framed with chunked coding
+    void pop_source();
+    void clear();
+
+    // writev() of the buffers before the first source: bytes sent, -1 if it would block
+    ssize_t write_to(int fd);
+
+    // Direct send from the front source (sendfile for files), see BodySource::send_direct
+    ssize_t send_source_direct(int fd, size_t max_bytes);
+
+    const Stats& get_stats() const {
+        return stats_;
+    }
+    void reset_stats() {
+        stats_ = Stats();
+    }
+
+   private:
+    static const int MAX_IOVECS = 64;  // Buffers gathered per writev()
+
+    struct Segment {
+        std::string data;    // Buffer segment
+        size_t offset;       // Bytes of data already sent
+        BodySource* source;  // Source segment when not NULL
+        bool chunked;        // Source output framed with chunked coding
+
+        Segment() : offset(0), source(NULL), chunked(false) {
+        }
+    };
+
+    std::deque<Segment> segments_;
+    size_t buffered_;
+    size_t source_count_;
+    std::string spare_;  // Buffer sent in full, kept while a source is queued
+    Stats stats_;
+
+    // Prevent copying
+    OutputQueue(const OutputQueue&);
+    OutputQueue& operator=(const OutputQueue&);
+};
+
+#endif  // OUTPUTQUEUE_HPP
@@ -0,0 +1,326 @@
+#include "Reactor.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "../utils/Log.hpp"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+const size_t Reactor::HANDOFF_QUEUE_SIZE;
+const size_t Reactor::MIN_RECV_BUFFER_MAX;
+
+Reactor::Reactor(size_t index, const GlobalBlock& global_block)
+    : index_(index),
+      buffer_pool_(
+          global_block.client_header_buffer_size,
+          std::max(global_block.client_header_max_size, MIN_RECV_BUFFER_MAX)),
+      max_header_size_(global_block.client_header_max_size),
+      body_buffer_size_(global_block.client_body_buffer_size),
+      body_temp_path_(global_block.client_body_temp_path),
+      handoffs_(HANDOFF_QUEUE_SIZE),
+      load_(0),
+      stopping_(0),
+      wakeup_read_fd_(-1),
+      wakeup_write_fd_(-1),
+      thread_(),
+      thread_started_(false) {
+    event_poll_.configure(
+        EventPoller::backend_from_string(global_block.event_backend), global_block.edge_triggered);
+}
+
+Reactor::~Reactor() {
+    stop();
+
+    // Connections queued but never picked up by the thread
+    Handoff handoff;
+    while (handoffs_.pop(handoff)) {
+        close(handoff.fd);
+    }
+
+    std::vector<int> connection_fds;
+    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
+        connection_fds.push_back(it->first);
+    }
+    for (size_t i = 0; i < connection_fds.size(); ++i) {
+        cleanup_connection(connection_fds[i]);
+    }
+
+    close_wakeup();
+}
+
+size_t Reactor::get_load() const {
+    return __atomic_load_n(&load_, __ATOMIC_RELAXED);
+}
+
+// ------------------------------------------------------------------
+// Same-thread use
+
+bool Reactor::add_connection(int client_fd, int local_port, const VirtualHosts* virtual_hosts) {
+    __atomic_add_fetch(&load_, 1, __ATOMIC_RELAXED);
+    try {
+        create_connection(client_fd, local_port, virtual_hosts);
+    } catch (const std::exception& e) {
+        Log::error("Failed to register connection: " + std::string(e.what()));
+        close(client_fd);
+        __atomic_sub_fetch(&load_, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+void Reactor::dispatch_event(const PollResult& event) {
+    // Resolved when the event is handled, not when it was collected: an earlier event of
+    // the same batch may have closed the fd (owner NONE) or handed it to a new owner
+    FdOwner owner = event_poll_.get_owner(event.fd);
+
+    if (event.timer != Timers::NONE) {
+        if (owner.type == FdOwner::CLIENT) {
+            process_timer_event(event, static_cast<Connection*>(owner.object));
+        }
+        return;
+    }
+
+    switch (owner.type) {
+        case FdOwner::CLIENT:
+            process_existing_connection(event, static_cast<Connection*>(owner.object));
+            break;
+        case FdOwner::CGI_STDOUT:
+            process_cgi_output(event, static_cast<Connection*>(owner.object));
+            break;
+        case FdOwner::CGI_STDIN:
+            process_cgi_input(event, static_cast<Connection*>(owner.object));
+            break;
+        case FdOwner::BODY_SOURCE:
+            process_body_source(static_cast<Connection*>(owner.object));
+            break;
+        case FdOwner::WAKEUP:
+            drain_wakeup();
+            accept_handoffs();
+            break;
+        default:
+            Log::warn("Unknown event on fd: " + Log::to_string(event.fd));
+            break;
+    }
+}
+
+// ------------------------------------------------------------------
+// Threaded use
+
+void Reactor::start() {
+    open_wakeup();
+
+    // Only the main thread handles SIGINT/SIGTERM, the new thread inherits the blocked mask
+    sigset_t blocked;
+    sigset_t previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    int result = pthread_create(&thread_, NULL, &Reactor::thread_main, this);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    if (result != 0) {
+        throw std::runtime_error("Failed to start reactor thread " + Log::to_string(index_));
+    }
+    thread_started_ = true;
+}
+
+bool Reactor::hand_off(int client_fd, int local_port, const VirtualHosts* virtual_hosts) {
+    __atomic_add_fetch(&load_, 1, __ATOMIC_RELAXED);
+    if (!handoffs_.push(Handoff(client_fd, local_port, virtual_hosts))) {
+        __atomic_sub_fetch(&load_, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    wake();
+    return true;
+}
+
+void Reactor::stop() {
+    if (!thread_started_) {
+        return;
+    }
+    __atomic_store_n(&stopping_, 1, __ATOMIC_RELEASE);
+    wake();
+    pthread_join(thread_, NULL);
+    thread_started_ = false;
+}
+
+void* Reactor::thread_main(void* arg) {
+    static_cast<Reactor*>(arg)->run();
+    return NULL;
+}
+
+void Reactor::run() {
+    while (!__atomic_load_n(&stopping_, __ATOMIC_ACQUIRE)) {
+        try {
+            PollResultVector events = event_poll_.poll_once();
+
+            for (size_t i = 0; i < events.size(); ++i) {
+                dispatch_event(events[i]);
+            }
+        } catch (const std::exception& e) {
+            Log::error("Runtime error in reactor " + Log::to_string(index_) + ": " + e.what());
+        }
+    }
+}
+
+// ------------------------------------------------------------------
+// Connection management
+
+void Reactor::create_connection(int client_fd, int local_port,
+                                const VirtualHosts* virtual_hosts) {
+    Connection* conn = new Connection(
+        client_fd, event_poll_, buffer_pool_, max_header_size_, body_buffer_size_,
+        body_temp_path_);
+    conn->set_listener(local_port, virtual_hosts);
+    connections_[client_fd] = conn;
+}
+
+void Reactor::accept_handoffs() {
+    Handoff handoff;
+    while (handoffs_.pop(handoff)) {
+        try {
+            create_connection(handoff.fd, handoff.local_port, handoff.virtual_hosts);
+        } catch (const std::exception& e) {
+            Log::error("Failed to register connection: " + std::string(e.what()));
+            close(handoff.fd);
+            __atomic_sub_fetch(&load_, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void Reactor::process_existing_connection(const PollResult& event, Connection* conn) {
+    if (event.has_error) {
+        conn->close_on_error();
+    } else {
+        // Both directions of the event are handled: an edge-triggered socket reports an edge
+        // once, and the events update after reading does not re-arm an unchanged interest set
+        if (event.received) {
+            conn->receive_completed_data(event.data, event.data_length);
+        }
+        if (event.can_read) {
+            conn->receive_client_data();
+        }
+        if (event.can_write && !conn->should_close()) {
+            conn->send_response_data();
+        }
+    }
+    if (conn->should_close()) {
+        cleanup_connection(conn->get_fd());
+    }
+}
+
+void Reactor::process_cgi_output(const PollResult& event, Connection* conn) {
+    conn->get_cgi_manager().process_cgi_output(event.fd, conn, event_poll_, event);
+
+    // CGI errors can leave the connection closing with nothing left to send
+    if (conn->should_close()) {
+        cleanup_connection(conn->get_fd());
+    }
+}
+
+void Reactor::process_cgi_input(const PollResult& event, Connection* conn) {
+    conn->get_cgi_manager().process_cgi_input(event.fd, conn, event_poll_, event);
+
+    // CGI errors can leave the connection closing with nothing left to send
+    if (conn->should_close()) {
+        cleanup_connection(conn->get_fd());
+    }
+}
+
+void Reactor::process_body_source(Connection* conn) {
+    // Readable, hung up or failed: the next read() on the source tells which
+    conn->resume_body_source();
+    if (conn->should_close()) {
+        cleanup_connection(conn->get_fd());
+    }
+}
+
+void Reactor::process_timer_event(const PollResult& event, Connection* conn) {
+    if (event.timer == Timers::IDLE) {
+        conn->handle_idle_timer();  // Sends 408 if the connection really is idle
+    } else if (event.timer == Timers::CGI) {
+        conn->handle_cgi_timer();
+    }
+    if (conn->should_close()) {
+        cleanup_connection(conn->get_fd());
+    }
+}
+
+void Reactor::cleanup_connection(int fd) {
+    ConnectionMapIt it = connections_.find(fd);
+    if (it != connections_.end()) {
+        delete it->second;
+        connections_.erase(it);
+        __atomic_sub_fetch(&load_, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// ------------------------------------------------------------------
+// Cross-thread wakeup
+
+void Reactor::open_wakeup() {
+#ifdef __linux__
+    wakeup_read_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    wakeup_write_fd_ = wakeup_read_fd_;
+    if (wakeup_read_fd_ == -1) {
+        throw std::runtime_error("Failed to create reactor eventfd");
+    }
+#else
+    int fds[2];
+    if (pipe(fds) == -1) {
+        throw std::runtime_error("Failed to create reactor wakeup pipe");
+    }
+    for (int i = 0; i < 2; ++i) {
+        fcntl(fds[i], F_SETFL, O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    wakeup_read_fd_ = fds[0];
+    wakeup_write_fd_ = fds[1];
+#endif
+    event_poll_.watch_fd(wakeup_read_fd_, PollEvents::READ, FdOwner(FdOwner::WAKEUP, this));
+}
+
+void Reactor::close_wakeup() {
+    if (wakeup_read_fd_ == -1) {
+        return;
+    }
+    event_poll_.unwatch_fd(wakeup_read_fd_);
+    close(wakeup_read_fd_);
+    if (wakeup_write_fd_ != wakeup_read_fd_) {
+        close(wakeup_write_fd_);
+    }
+    wakeup_read_fd_ = -1;
+    wakeup_write_fd_ = -1;
+}
+
+void Reactor::wake() {
+    // A full eventfd counter or pipe already guarantees a pending wakeup
+#ifdef __linux__
+    eventfd_write(wakeup_write_fd_, 1);
+#else
+    char byte = 1;
+    ssize_t written = write(wakeup_write_fd_, &byte, 1);
+    (void)written;
+#endif
+}
+
+void Reactor::drain_wakeup() {
+    // Reset before draining the queue: a handoff pushed after this point wakes us again
+#ifdef __linux__
+    eventfd_t value;
+    eventfd_read(wakeup_read_fd_, &value);
+#else
+    char buffer[64];
+    while (read(wakeup_read_fd_, buffer, sizeof(buffer)) > 0) {
+    }
+#endif
+}
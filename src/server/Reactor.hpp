@@ -0,0 +1,108 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <pthread.h>
+
+#include "../config/contexts/GlobalBlock.hpp"
+#include "../config/contexts/ServerBlock.hpp"
+#include "../utils/Types.hpp"
+#include "BufferPool.hpp"
+#include "Connection.hpp"
+#include "EventPoller.hpp"
+#include "SpscQueue.hpp"
+
+/**
+ * One event loop with the connections it owns.
+ *
+ * With a single reactor the Server drives it from the main thread: listener events are
+ * handled by the Server, everything else is forwarded to dispatch_event().
+ *
+ * With reactor_threads > 1 every reactor runs its loop on its own thread. The acceptor
+ * (the Server's main thread) hands accepted fds over through a single-producer queue and
+ * wakes the reactor through an eventfd (a pipe outside Linux). From then on the
+ * connection, its CGI pipes and its timers only ever touch this reactor's poller.
+ */
+class Reactor {
+   public:
+    Reactor(size_t index, const GlobalBlock& global_block);
+    ~Reactor();
+
+    EventPoller& get_poller() {
+        return event_poll_;
+    }
+    size_t get_index() const {
+        return index_;
+    }
+
+    // Connections owned or queued for this reactor, readable from any thread
+    size_t get_load() const;
+
+    // Same-thread use (single reactor driven by the Server)
+    bool add_connection(int client_fd, int local_port,
+                        const VirtualHosts* virtual_hosts);  // false if closed
+    void dispatch_event(const PollResult& event);
+
+    // Threaded use
+    void start();  // Spawn the reactor thread
+    bool hand_off(int client_fd, int local_port,
+                  const VirtualHosts* virtual_hosts);  // false when queue is full
+    void stop();                                       // Stop and join the thread
+
+   private:
+    // Reactor constants
+    static const size_t HANDOFF_QUEUE_SIZE = 4096;  // Accepted fds in flight per reactor
+    static const size_t MIN_RECV_BUFFER_MAX = 32768;  // Largest receive buffer at least (bodies)
+
+    // Accepted connection travelling from the acceptor to the reactor thread
+    struct Handoff {
+        int fd;
+        int local_port;                     // Port of the listening socket
+        const VirtualHosts* virtual_hosts;  // Server blocks of that port
+
+        Handoff() : fd(-1), local_port(0), virtual_hosts(NULL) {
+        }
+        Handoff(int client_fd, int port, const VirtualHosts* hosts)
+            : fd(client_fd), local_port(port), virtual_hosts(hosts) {
+        }
+    };
+
+    size_t index_;                 // Position in the Server's reactor list (for logs)
+    EventPoller event_poll_;       // Poller owned by this reactor
+    ConnectionMap connections_;    // Connections owned by this reactor
+    BufferPool buffer_pool_;       // Receive buffers of connections_
+    size_t max_header_size_;       // client_header_max_size
+    size_t body_buffer_size_;      // client_body_buffer_size
+    std::string body_temp_path_;   // client_body_temp_path
+    SpscQueue<Handoff> handoffs_;  // Acceptor -> reactor thread
+    size_t load_;                  // Owned + queued connections (atomic)
+    int stopping_;                 // Set by stop() (atomic)
+    int wakeup_read_fd_;           // Watched by event_poll_
+    int wakeup_write_fd_;          // Same as wakeup_read_fd_ with eventfd
+    pthread_t thread_;
+    bool thread_started_;
+
+    static void* thread_main(void* arg);
+    void run();
+
+    // Connection management
+    void create_connection(int client_fd, int local_port, const VirtualHosts* virtual_hosts);
+    void accept_handoffs();
+    void process_existing_connection(const PollResult& event, Connection* conn);
+    void process_cgi_output(const PollResult& event, Connection* conn);
+    void process_cgi_input(const PollResult& event, Connection* conn);
+    void process_body_source(Connection* conn);
+    void process_timer_event(const PollResult& event, Connection* conn);
+    void cleanup_connection(int fd);
+
+    // Cross-thread wakeup
+    void open_wakeup();
+    void close_wakeup();
+    void wake();
+    void drain_wakeup();
+
+    // Prevent copying
+    Reactor(const Reactor&);
+    Reactor& operator=(const Reactor&);
+};
+
+#endif  // REACTOR_HPP
@@ -0,0 +1,72 @@
+#include "RecvBuffer.hpp"
+
+#include <cstring>
+
+RecvBuffer::RecvBuffer(BufferPool& pool)
+    : pool_(pool), storage_(NULL), capacity_(pool.get_initial_size()), start_(0), end_(0) {
+}
+
+RecvBuffer::~RecvBuffer() {
+    if (storage_) {
+        pool_.recycle(storage_, capacity_);
+    }
+}
+
+void RecvBuffer::consume(size_t count) {
+    start_ += count;
+    if (start_ == end_) {
+        start_ = 0;
+        end_ = 0;
+    }
+}
+
+bool RecvBuffer::prepare() {
+    if (!storage_) {
+        storage_ = pool_.acquire(capacity_);
+        return true;
+    }
+    if (end_ < capacity_) {
+        return true;
+    }
+    if (start_ > 0) {
+        // Slide the unconsumed tail to the front
+        std::memmove(storage_, storage_ + start_, end_ - start_);
+        end_ -= start_;
+        start_ = 0;
+        return true;
+    }
+    return grow();
+}
+
+void RecvBuffer::commit(size_t count) {
+    end_ += count;
+}
+
+bool RecvBuffer::grow() {
+    size_t new_capacity = pool_.next_size(capacity_);
+    if (new_capacity == 0) {
+        return false;
+    }
+    if (!storage_) {
+        capacity_ = new_capacity;
+        return true;
+    }
+
+    char* new_storage = pool_.acquire(new_capacity);
+    std::memcpy(new_storage, storage_ + start_, end_ - start_);
+    pool_.recycle(storage_, capacity_);
+    storage_ = new_storage;
+    capacity_ = new_capacity;
+    end_ -= start_;
+    start_ = 0;
+    return true;
+}
+
+void RecvBuffer::release() {
+    if (!storage_ || !empty()) {
+        return;
+    }
+    pool_.recycle(storage_, capacity_);
+    storage_ = NULL;
+    capacity_ = pool_.get_initial_size();
+}
@@ -0,0 +1,58 @@
+#ifndef RECVBUFFER_HPP
+#define RECVBUFFER_HPP
+
+#include <cstddef>
+
+#include "BufferPool.hpp"
+
+/**
+ * Bytes received on a connection and not yet consumed by the request parser.
+ *
+ * recv() writes straight into the storage and the parser reads it in place, consumed
+ * bytes only advance an offset. Storage comes from the reactor's BufferPool: it starts at
+ * the initial size class, moves up one class when a read fills it, and goes back to the
+ * pool once nothing is buffered, so an idle keep-alive connection holds no buffer at all.
+ */
+class RecvBuffer {
+   public:
+    explicit RecvBuffer(BufferPool& pool);
+    ~RecvBuffer();
+
+    // Unconsumed bytes
+    const char* data() const {
+        return storage_ + start_;
+    }
+    size_t size() const {
+        return end_ - start_;
+    }
+    bool empty() const {
+        return start_ == end_;
+    }
+    void consume(size_t count);
+
+    // Room for the next recv(), false when the largest size class is full
+    bool prepare();
+    char* write_ptr() {
+        return storage_ + end_;
+    }
+    size_t writable() const {
+        return capacity_ - end_;
+    }
+    void commit(size_t count);
+
+    bool grow();     // Next size class, keeps the unconsumed bytes. False at the largest
+    void release();  // Storage back to the pool if nothing is buffered
+
+   private:
+    BufferPool& pool_;
+    char* storage_;    // NULL while released
+    size_t capacity_;  // Size class of storage_ (or of the next acquire)
+    size_t start_;     // First unconsumed byte
+    size_t end_;       // End of received bytes
+
+    // Prevent copying
+    RecvBuffer(const RecvBuffer&);
+    RecvBuffer& operator=(const RecvBuffer&);
+};
+
+#endif  // RECVBUFFER_HPP
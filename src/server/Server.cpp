@@ -19,61 +19,149 @@
 // Server startup constants
 static const char DEFAULT_SERVER_URL[] = "http://localhost:8080/";
 
+// Connection admission constants
+static const size_t LOW_WATER_PERCENT = 90;  // Paused listeners resume below this share
+static const int PAUSED_RECHECK_MS = 50;     // Wait between checks while paused
+
 // Initialize static members
 std::vector<ServerBlock> Server::server_blocks_;
-std::map<int, const ServerBlock*> Server::default_blocks_;
+VirtualHostMap Server::virtual_hosts_;
 std::map<int, Socket> Server::listen_sockets_;
 
 // ------------------------------------------------------------------
 // Core server methods
 
-Server::Server(const std::string& config_path) {
+Server::Server(const std::string& config_path)
+    : next_reactor_(0), worker_index_(-1), accepting_paused_(false) {
     // Load configuration
-    Config::load_config(config_path, server_blocks_);
-    setup_listeners();
-    update_default_blocks();
+    Config::load_config(config_path, server_blocks_, global_block_);
+
+    // With worker processes, every worker opens its own poller and listeners after fork()
+    if (global_block_.worker_processes == 1) {
+        start_worker();
+    }
 }
 
 Server::~Server() {
-    // Clean up all connections
-    std::vector<int> connection_fds;
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        connection_fds.push_back(it->first);
+    // Each reactor stops its thread and closes its connections
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        delete reactors_[i];
     }
+    reactors_.clear();
+}
 
-    // Close and clean up each connection
-    for (size_t i = 0; i < connection_fds.size(); ++i) {
-        cleanup_connection(connection_fds[i]);
+void Server::run() {
+    // The master only returns from run_master() inside a freshly forked worker
+    if (global_block_.worker_processes > 1 && !run_master()) {
+        return;
     }
-
-    connections_.clear();
+    run_event_loop();
 }
 
-void Server::run() {
+void Server::run_event_loop() {
     // Log link to server for easy click access
     Log::info("Server running at " + std::string(DEFAULT_SERVER_URL));
 
+    // With threaded reactors this loop only accepts, otherwise it also serves connections
+    start_reactors();
+    EventPoller& poller = listener_poller();
+
     while (Signals::should_continue()) {
         try {
-            cleanup_idle_connections();
-            std::vector<PollResult> events = event_poll_.poll_once();
+            // Paused listeners only come back by polling the connection count
+            int timeout_ms = accepting_paused_ ? PAUSED_RECHECK_MS : EventPoller::POLL_TIMEOUT_MS;
+            std::vector<PollResult> events = poller.poll_once(timeout_ms);
 
             for (size_t i = 0; i < events.size(); ++i) {
                 const PollResult& event = events[i];
 
-                if (process_new_connection(event)) {
-                    continue;
-                } else if (process_existing_connection(event)) {
-                    continue;
-                } else {
-                    Log::warn("Unknown event on fd: " + Log::to_string(event.fd));
-                }
+                dispatch_event(event);
+            }
+
+            if (accepting_paused_) {
+                resume_accepting_if_drained();
             }
-            check_cgi_processes();
         } catch (const std::exception& e) {
             Log::error("Runtime error: " + std::string(e.what()));
         }
     }
+    stop_reactors();
+    log_accept_stats();
+}
+
+// ------------------------------------------------------------------
+// Event loop setup
+
+void Server::start_worker() {
+    setup_event_poller();
+    setup_listeners();
+    build_virtual_hosts();
+}
+
+void Server::setup_event_poller() {
+    EventPoller::Backend backend = EventPoller::backend_from_string(global_block_.event_backend);
+    for (int i = 0; i < global_block_.reactor_threads; ++i) {
+        reactors_.push_back(new Reactor(i, global_block_));
+    }
+
+    // Listeners get their own level-triggered poller when the reactors run on threads
+    if (is_threaded()) {
+        event_poll_.configure(backend, false);
+    }
+
+    EventPoller& poller = reactors_[0]->get_poller();
+    if (poller.get_backend() != backend) {
+        Log::warn(
+            "Event backend " + global_block_.event_backend + " is not available, falling back to " +
+            EventPoller::backend_to_string(poller.get_backend()));
+    }
+
+    std::string mode = poller.is_edge_triggered() ? " (edge-triggered)" : "";
+    Log::info("Event backend: " + EventPoller::backend_to_string(poller.get_backend()) + mode);
+}
+
+// ------------------------------------------------------------------
+// Reactors
+
+EventPoller& Server::listener_poller() {
+    return is_threaded() ? event_poll_ : reactors_[0]->get_poller();
+}
+
+Reactor* Server::select_reactor() {
+    if (global_block_.reactor_balance == "least_loaded") {
+        Reactor* best = reactors_[0];
+        for (size_t i = 1; i < reactors_.size(); ++i) {
+            if (reactors_[i]->get_load() < best->get_load()) {
+                best = reactors_[i];
+            }
+        }
+        return best;
+    }
+
+    Reactor* reactor = reactors_[next_reactor_];
+    next_reactor_ = (next_reactor_ + 1) % reactors_.size();
+    return reactor;
+}
+
+void Server::start_reactors() {
+    if (!is_threaded()) {
+        return;
+    }
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        reactors_[i]->start();
+    }
+    Log::info(
+        "Started " + Log::to_string(reactors_.size()) + " reactor threads (" +
+        global_block_.reactor_balance + ")");
+}
+
+void Server::stop_reactors() {
+    if (!is_threaded()) {
+        return;
+    }
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        reactors_[i]->stop();
+    }
 }
 
 // ------------------------------------------------------------------
@@ -114,201 +202,178 @@ void Server::setup_single_listener(int port) {
         listen_sockets_.insert(std::pair<int, Socket>(port, Socket(port)));
     Socket& socket = result.first->second;
 
-    socket.configure_socket();
-    event_poll_.watch_fd(socket.get_fd(), PollEvents::READ);
+    socket.configure_socket(global_block_.worker_processes > 1);
+    listener_poller().watch_fd(
+        socket.get_fd(), PollEvents::READ, FdOwner(FdOwner::LISTENER, &socket));
     Log::info("Listening on port " + Log::to_string(port));
 }
 
-bool Server::process_new_connection(const PollResult& event) {
-    Socket* listen_socket = get_listen_socket(event.fd);
-    if (!listen_socket) {
-        return false;
-    }
-
+void Server::process_new_connection(const PollResult& event, Socket* listen_socket) {
     if (event.has_error) {
         Log::error("Error on listening socket: " + Log::to_string(event.fd));
     } else if (event.can_read) {
-        handle_new_connection(listen_socket);
+        accept_connections(listen_socket);
     }
-    return true;
 }
 
-Socket* Server::get_listen_socket(int fd) const {
-    for (SocketMapConstIt it = listen_sockets_.begin(); it != listen_sockets_.end(); ++it) {
-        if (fd == it->second.get_fd()) {
-            return const_cast<Socket*>(&it->second);
+void Server::accept_connections(Socket* listen_socket) {
+    // Drain the backlog up to the batch budget, the rest waits for the next wakeup
+    for (int i = 0; i < global_block_.accept_batch; ++i) {
+        if (connection_count() >= static_cast<size_t>(global_block_.max_connections)) {
+            pause_accepting();
+            return;
         }
+
+        int client_fd = listen_socket->accept_connection();
+        if (client_fd < 0) {
+            return;  // Backlog drained
+        }
+        register_connection(listen_socket, client_fd);
     }
-    return NULL;
 }
 
-void Server::handle_new_connection(Socket* listen_socket) {
-    int client_fd = listen_socket->accept_connection();
-    if (client_fd >= 0) {
-        Log::info("New connection accepted (fd: " + Log::to_string(client_fd) + ")");
-        Connection* conn = new Connection(client_fd, event_poll_);
-
-        // Find the port associated with this listening socket
-        int port = -1;
-        for (SocketMapConstIt it = listen_sockets_.begin(); it != listen_sockets_.end(); ++it) {
-            if (it->second.get_fd() == listen_socket->get_fd()) {
-                port = it->first;
-                break;
-            }
-        }
+void Server::accept_completed(int listen_fd, int client_fd) {
+    // Accepted by the poller already (io_uring multishot accept). Over the limit it goes back
+    // to the poller, which reports it again once the listener is watched.
+    if (accepting_paused_ ||
+        connection_count() >= static_cast<size_t>(global_block_.max_connections)) {
+        listener_poller().defer_accepted(listen_fd, client_fd);
+        pause_accepting();
+        return;
+    }
 
-        // Set default server block for this port
-        if (port != -1) {
-            DefaultBlockMapConstIt it = default_blocks_.find(port);
-            if (it != default_blocks_.end()) {
-                conn->set_server_block(it->second);
-            }
+    for (SocketMapIt it = listen_sockets_.begin(); it != listen_sockets_.end(); ++it) {
+        if (it->second.get_fd() == listen_fd) {
+            register_connection(&it->second, client_fd);
+            return;
         }
-
-        connections_[client_fd] = conn;
     }
+    close(client_fd);
 }
 
-// ------------------------------------------------------------------
-// Connection management
-
-bool Server::process_existing_connection(const PollResult& event) {
-    ConnectionMapIt conn_it = connections_.find(event.fd);
-    if (conn_it == connections_.end()) {
-        // Check if this might be a CGI I/O fd
-        if (process_cgi_output(event)) {
-            return true;
-        }
-        return process_cgi_input(event);
+void Server::register_connection(Socket* listen_socket, int client_fd) {
+    Log::info("New connection accepted (fd: " + Log::to_string(client_fd) + ")");
+
+    // Server blocks of the port of this listening socket, recorded on each connection
+    int local_port = listen_socket->get_port();
+    if (admit_connection(client_fd, local_port, get_virtual_hosts(local_port))) {
+        accept_stats_.accepted++;
+    } else {
+        accept_stats_.rejected++;
     }
+}
 
-    Connection* conn = conn_it->second;
-    if (event.has_error) {
-        conn->close_on_error();
-    } else if (event.can_read) {
-        conn->receive_client_data();
-    } else if (event.can_write) {
-        conn->send_response_data();
+bool Server::admit_connection(int client_fd, int local_port, const VirtualHosts* virtual_hosts) {
+    if (!is_threaded()) {
+        return reactors_[0]->add_connection(client_fd, local_port, virtual_hosts);
     }
-    if (conn->should_close()) {
-        cleanup_connection(event.fd);
+
+    Reactor* reactor = select_reactor();
+    if (!reactor->hand_off(client_fd, local_port, virtual_hosts)) {
+        Log::warn(
+            "Reactor " + Log::to_string(reactor->get_index()) +
+            " handoff queue is full, dropping connection");
+        close(client_fd);
+        return false;
     }
     return true;
 }
 
-bool Server::process_cgi_output(const PollResult& event) {
-    // Find connection with matching CGI stdout_fd
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        Connection* conn = it->second;
-        if (conn->is_cgi_active()) {
-            // Use CgiManager to process the output
-            if (conn->get_cgi_manager().process_cgi_output(event.fd, conn, event_poll_, event)) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
+// ------------------------------------------------------------------
+// Connection admission
 
-bool Server::process_cgi_input(const PollResult& event) {
-    // Find connection with matching CGI stdin_fd
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        Connection* conn = it->second;
-        if (conn->is_cgi_active()) {
-            // Use CgiManager to process the input
-            if (conn->get_cgi_manager().process_cgi_input(event.fd, conn, event_poll_, event)) {
-                return true;
-            }
-        }
+size_t Server::connection_count() const {
+    size_t count = 0;
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        count += reactors_[i]->get_load();
     }
-    return false;
+    return count;
 }
 
-void Server::cleanup_idle_connections() {
-    time_t current_time = time(NULL);
+void Server::pause_accepting() {
+    if (accepting_paused_) {
+        return;
+    }
 
-    // Check for idle connections and let them handle timeout response
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        it->second->is_idle(current_time);  // This will send 408 if timeout
+    // Pending connections stay in the kernel backlog, or deferred by the poller, until the
+    // count drops
+    for (SocketMapIt it = listen_sockets_.begin(); it != listen_sockets_.end(); ++it) {
+        listener_poller().unwatch_fd(it->second.get_fd());
     }
+    accepting_paused_ = true;
+    accept_stats_.paused++;
+    Log::warn(
+        "Connection limit reached (" + Log::to_string(global_block_.max_connections) +
+        "), pausing accepts");
+}
 
-    // Then clean up connections that should be closed
-    std::vector<int> to_close;
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        if (it->second->should_close()) {
-            to_close.push_back(it->first);
-        }
+void Server::resume_accepting_if_drained() {
+    size_t low_water = global_block_.max_connections * LOW_WATER_PERCENT / 100;
+    if (connection_count() >= low_water) {
+        return;
     }
 
-    for (size_t i = 0; i < to_close.size(); ++i) {
-        cleanup_connection(to_close[i]);
+    for (SocketMapIt it = listen_sockets_.begin(); it != listen_sockets_.end(); ++it) {
+        listener_poller().watch_fd(
+            it->second.get_fd(), PollEvents::READ, FdOwner(FdOwner::LISTENER, &it->second));
     }
+    accepting_paused_ = false;
+    Log::info("Resuming accepts (" + Log::to_string(connection_count()) + " connections)");
 }
 
-void Server::cleanup_connection(int fd) {
-    ConnectionMapIt it = connections_.find(fd);
-    if (it != connections_.end()) {
-        delete it->second;
-        connections_.erase(it);
+void Server::log_accept_stats() const {
+    Log::info(
+        "Connections accepted: " + Log::to_string(accept_stats_.accepted) +
+        ", rejected: " + Log::to_string(accept_stats_.rejected) +
+        ", accept pauses: " + Log::to_string(accept_stats_.paused));
+}
+
+// ------------------------------------------------------------------
+// Event dispatch
+
+void Server::dispatch_event(const PollResult& event) {
+    // Listeners are handled here, everything else belongs to the (single) reactor
+    // Accepted connections too, even when an earlier event of the batch paused the listener
+    const FdOwner& owner = listener_poller().get_owner(event.fd);
+    if (event.accepted_fd >= 0) {
+        accept_completed(event.fd, event.accepted_fd);
+    } else if (event.timer == Timers::NONE && owner.type == FdOwner::LISTENER) {
+        process_new_connection(event, static_cast<Socket*>(owner.object));
+    } else if (!is_threaded()) {
+        reactors_[0]->dispatch_event(event);
     }
 }
 
 // ------------------------------------------------------------------
 // Server block management
 
-void Server::update_default_blocks() {
-    default_blocks_.clear();
+void Server::build_virtual_hosts() {
+    virtual_hosts_.clear();
 
-    // For each port, find the default server block
+    // For each port, register the server blocks listening on it by name
     for (SocketMapConstIt socket = listen_sockets_.begin(); socket != listen_sockets_.end();
          ++socket) {
         int port = socket->first;
-        const ServerBlock* default_block = NULL;
+        VirtualHosts& virtual_hosts = virtual_hosts_[port];
 
-        // Find default server for this port
         for (ServerBlockVectorConstIt block = server_blocks_.begin(); block != server_blocks_.end();
              ++block) {
             for (ListenVectorConstIt listen = block->listen.begin(); listen != block->listen.end();
                  ++listen) {
                 if (listen->second == port) {
-                    if (block->is_default || default_block == NULL) {
-                        default_block = &(*block);
+                    virtual_hosts.add_server(&(*block));
+                    if (block->is_default || virtual_hosts.get_default() == NULL) {
+                        virtual_hosts.set_default(&(*block));
                     }
+                    break;
                 }
             }
         }
-
-        if (default_block) {
-            default_blocks_[port] = default_block;
-        }
     }
 }
 
 // Static method implementation
-const ServerBlock* Server::get_server_block(const std::string& host, int port) {
-    // First try to find a server matching both host and port
-    for (ServerBlockVectorConstIt it = server_blocks_.begin(); it != server_blocks_.end(); ++it) {
-        for (ListenVectorConstIt listen = it->listen.begin(); listen != it->listen.end();
-             ++listen) {
-            if (listen->second == port && it->matches_server_name(host)) {
-                return &(*it);
-            }
-        }
-    }
-
-    // If no match, return the default server for this port
-    DefaultBlockMapConstIt it = default_blocks_.find(port);
-    return (it != default_blocks_.end()) ? it->second : NULL;
-}
-
-void Server::check_cgi_processes() {
-    // Iterate through all connections and check for active CGI processes
-    for (ConnectionMapIt it = connections_.begin(); it != connections_.end(); ++it) {
-        Connection* connection = it->second;
-        CgiManager& cgi_manager = connection->get_cgi_manager();
-
-        if (cgi_manager.is_cgi_active(connection)) {
-            cgi_manager.update_cgi_process(connection, event_poll_);
-        }
-    }
+const VirtualHosts* Server::get_virtual_hosts(int port) {
+    VirtualHostMapConstIt it = virtual_hosts_.find(port);
+    return (it != virtual_hosts_.end()) ? &it->second : NULL;
 }
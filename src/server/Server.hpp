@@ -1,25 +1,51 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
+#include <sys/types.h>
+
 #include <map>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "../config/contexts/GlobalBlock.hpp"
 #include "../config/contexts/ServerBlock.hpp"
 #include "../utils/Types.hpp"
 #include "Connection.hpp"
 #include "EventPoller.hpp"
+#include "Reactor.hpp"
 #include "Socket.hpp"
+#include "VirtualHosts.hpp"
 
+/**
+ * Owns the configuration, the listeners and the reactors.
+ *
+ * The static configuration state is written once while starting up (before worker
+ * processes are forked and reactor threads are started) and is read-only afterwards,
+ * which is what lets every reactor thread read it without locking.
+ */
 class Server {
    private:
     static ServerBlockVector server_blocks_;  // Store server blocks
-    static DefaultBlockMap default_blocks_;   // Quick lookup for default blocks per port
+    static VirtualHostMap virtual_hosts_;     // Server blocks by name, per port
     static SocketMap listen_sockets_;         // Sockets by port
-    EventPoller event_poll_;                  // Event loop helper
-    ConnectionMap connections_;               // Active connections
-    void check_cgi_processes();
+    GlobalBlock global_block_;                // Main-context settings (event backend, ...)
+    EventPoller event_poll_;                  // Acceptor poller (threaded reactors only)
+    ReactorVector reactors_;                  // Event loops owning the connections
+    size_t next_reactor_;                     // Round-robin handoff position
+    int worker_index_;                        // Index of this worker, -1 in the master
+
+    // Connection admission counters
+    struct AcceptStats {
+        unsigned long accepted;  // Connections handed to a reactor
+        unsigned long rejected;  // Accepted but closed at once (handoff queue full, ...)
+        unsigned long paused;    // Times max_connections paused the listeners
+
+        AcceptStats() : accepted(0), rejected(0), paused(0) {
+        }
+    };
+    AcceptStats accept_stats_;
+    bool accepting_paused_;  // Listeners unwatched because of max_connections
 
    public:
     explicit Server(const std::string& config_path);
@@ -33,8 +59,8 @@ class Server {
     void run();
 
     // Static methods for Connection class to use
-    static const ServerBlock* get_server_block(const std::string& host, int port);
-    static SocketMap& get_listen_sockets() {
+    static const VirtualHosts* get_virtual_hosts(int port);
+    static const SocketMap& get_listen_sockets() {
         return listen_sockets_;
     }
 
@@ -47,19 +73,53 @@ class Server {
     // Listener management
     void setup_listeners();
     void setup_single_listener(int port);
-    bool process_new_connection(const PollResult& event);
-    Socket* get_listen_socket(int fd) const;
-    void handle_new_connection(Socket* listen_socket);
+    void process_new_connection(const PollResult& event, Socket* listen_socket);
+    void accept_connections(Socket* listen_socket);
+    void accept_completed(int listen_fd, int client_fd);
+    void register_connection(Socket* listen_socket, int client_fd);
+    bool admit_connection(int client_fd, int local_port, const VirtualHosts* virtual_hosts);
+
+    // Connection admission
+    size_t connection_count() const;
+    void pause_accepting();
+    void resume_accepting_if_drained();
+    void log_accept_stats() const;
+
+    // Event dispatch through the poller's fd-owner registry
+    void dispatch_event(const PollResult& event);
 
-    // Connection management
-    bool process_existing_connection(const PollResult& event);
-    bool process_cgi_output(const PollResult& event);
-    bool process_cgi_input(const PollResult& event);
-    void cleanup_idle_connections();
-    void cleanup_connection(int fd);
+    // Reactors
+    bool is_threaded() const {
+        return reactors_.size() > 1;
+    }
+    EventPoller& listener_poller();
+    Reactor* select_reactor();
+    void start_reactors();
+    void stop_reactors();
 
     // Server block management
-    void update_default_blocks();
+    void build_virtual_hosts();
+
+    // Event loop setup
+    void start_worker();
+    void setup_event_poller();
+    void run_event_loop();
+
+    // Worker processes (Server_workers.cpp)
+    struct WorkerProcess {
+        pid_t pid;        // -1 while not running
+        long started_ms;  // Monotonic spawn time, to detect crash loops
+
+        WorkerProcess() : pid(-1), started_ms(0) {
+        }
+    };
+    std::vector<WorkerProcess> workers_;  // Supervised workers (master only)
+
+    bool run_master();
+    bool spawn_worker(size_t index);
+    void stop_workers();
+    void pin_worker_to_cpu(size_t index);
+    static std::string describe_exit_status(int status);
 };
 
 #endif  // SERVER_HPP
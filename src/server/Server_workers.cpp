@@ -0,0 +1,157 @@
+// src/server/Server_workers.cpp
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include "../utils/Clock.hpp"
+#include "../utils/Log.hpp"
+#include "../utils/Signals.hpp"
+#include "Server.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
+
+// Worker supervision constants
+static const long WORKER_MIN_UPTIME_MS = 1000;  // Faster exits are treated as a crash loop
+static const unsigned int RESPAWN_DELAY_SECONDS = 1;
+
+// ------------------------------------------------------------------
+// Master process
+
+bool Server::run_master() {
+    Log::info(
+        "Starting " + Log::to_string(global_block_.worker_processes) +
+        " worker processes (master pid: " + Log::to_string(getpid()) + ")");
+
+    workers_.assign(global_block_.worker_processes, WorkerProcess());
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (spawn_worker(i)) {
+            return true;
+        }
+    }
+
+    // Supervise until SIGINT/SIGTERM interrupts waitpid()
+    while (Signals::should_continue()) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid <= 0) {
+            continue;
+        }
+
+        size_t index = 0;
+        while (index < workers_.size() && workers_[index].pid != pid) {
+            ++index;
+        }
+        if (index == workers_.size()) {
+            continue;
+        }
+        workers_[index].pid = -1;
+        bool exited_early = Clock::update() - workers_[index].started_ms < WORKER_MIN_UPTIME_MS;
+
+        // Workers exit with EXIT_FAILURE when they cannot start (bind failure, ...),
+        // respawning them would only repeat the error. Later, it is a runtime failure.
+        if (exited_early && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE) {
+            stop_workers();
+            throw std::runtime_error("Worker " + Log::to_string(index) + " failed to start");
+        }
+
+        Log::warn(
+            "Worker " + Log::to_string(index) + " (pid: " + Log::to_string(pid) + ") " +
+            describe_exit_status(status) + ", respawning");
+
+        if (exited_early) {
+            sleep(RESPAWN_DELAY_SECONDS);
+        }
+        if (Signals::should_continue() && spawn_worker(index)) {
+            return true;
+        }
+    }
+
+    stop_workers();
+    return false;
+}
+
+bool Server::spawn_worker(size_t index) {
+    pid_t master_pid = getpid();
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("Failed to fork worker process");
+    }
+
+    if (pid == 0) {
+        // Worker: forget the supervision state and open its own poller and listeners
+        worker_index_ = static_cast<int>(index);
+        workers_.clear();
+
+#ifdef __linux__
+        // Do not outlive a master that was killed without forwarding SIGTERM
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != master_pid) {
+            std::exit(EXIT_SUCCESS);
+        }
+#else
+        (void)master_pid;
+#endif
+
+        if (global_block_.worker_cpu_affinity) {
+            pin_worker_to_cpu(index);
+        }
+        start_worker();
+        return true;
+    }
+
+    workers_[index].pid = pid;
+    workers_[index].started_ms = Clock::update();
+    Log::info("Worker " + Log::to_string(index) + " started (pid: " + Log::to_string(pid) + ")");
+    return false;
+}
+
+void Server::stop_workers() {
+    // Forward the shutdown to every worker, then wait for them to finish
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (workers_[i].pid > 0) {
+            kill(workers_[i].pid, SIGTERM);
+        }
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (workers_[i].pid > 0) {
+            waitpid(workers_[i].pid, NULL, 0);
+            workers_[i].pid = -1;
+        }
+    }
+    Log::info("All worker processes stopped");
+}
+
+// ------------------------------------------------------------------
+// Worker helpers
+
+void Server::pin_worker_to_cpu(size_t index) {
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+        Log::warn("Failed to pin worker " + Log::to_string(index) + " to a CPU");
+    }
+#else
+    (void)index;
+    Log::warn("worker_cpu_affinity is not supported on this platform");
+#endif
+}
+
+std::string Server::describe_exit_status(int status) {
+    if (WIFSIGNALED(status)) {
+        return "was killed by signal " + Log::to_string(WTERMSIG(status));
+    }
+    return "exited with status " + Log::to_string(WEXITSTATUS(status));
+}
@@ -20,11 +20,12 @@ class Socket {
     Socket(const Socket& other);
     Socket& operator=(const Socket& other);
 
-    void configure_socket();
+    void configure_socket(bool reuse_port = false);
     int accept_connection();
 
     // Utility methods
     int get_fd() const;
+    int get_port() const;
     void close_socket();
 };
 
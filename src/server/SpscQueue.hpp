@@ -0,0 +1,65 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Bounded lock-free queue between exactly one producer thread and one consumer thread.
+ *
+ * The producer only advances tail_ and the consumer only advances head_. Each side
+ * publishes its own index with a release store and reads the other one with an acquire
+ * load, so an item is fully written before the consumer can see it.
+ */
+template <typename T>
+class SpscQueue {
+   public:
+    explicit SpscQueue(size_t capacity)
+        : slots_(round_up_power_of_two(capacity)), mask_(slots_.size() - 1), head_(0), tail_(0) {
+    }
+
+    // Producer side, returns false when the queue is full
+    bool push(const T& item) {
+        size_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        if (tail - __atomic_load_n(&head_, __ATOMIC_ACQUIRE) == slots_.size()) {
+            return false;
+        }
+        slots_[tail & mask_] = item;
+        __atomic_store_n(&tail_, tail + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // Consumer side, returns false when the queue is empty
+    bool pop(T& item) {
+        size_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        if (head == __atomic_load_n(&tail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        item = slots_[head & mask_];
+        __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+   private:
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> slots_;  // Ring storage, size is a power of two
+    size_t mask_;           // slots_.size() - 1
+    size_t head_;           // Next slot to pop (written by the consumer)
+    char padding_[CACHE_LINE_SIZE];  // Keeps head_ and tail_ off the same cache line
+    size_t tail_;                    // Next slot to push (written by the producer)
+
+    static size_t round_up_power_of_two(size_t value) {
+        size_t size = 1;
+        while (size < value) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // Prevent copying
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+};
+
+#endif  // SPSCQUEUE_HPP
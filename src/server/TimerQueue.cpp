@@ -0,0 +1,94 @@
+#include "TimerQueue.hpp"
+
+#include <algorithm>
+#include <functional>
+
+const size_t TimerQueue::COMPACT_THRESHOLD;
+
+TimerQueue::TimerQueue() : next_sequence_(0) {
+}
+
+// ----------------------------------------------------------------------------
+// Scheduling
+// ----------------------------------------------------------------------------
+
+void TimerQueue::schedule(int fd, Timers::Type type, long deadline_ms) {
+    Entry entry;
+    entry.deadline_ms = deadline_ms;
+    entry.sequence = next_sequence_++;
+    entry.fd = fd;
+    entry.type = type;
+
+    active_[Key(fd, type)] = entry;
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+
+    if (heap_.size() > COMPACT_THRESHOLD && heap_.size() > 2 * active_.size()) {
+        compact();
+    }
+}
+
+void TimerQueue::cancel(int fd, Timers::Type type) {
+    active_.erase(Key(fd, type));
+}
+
+void TimerQueue::cancel_all(int fd) {
+    active_.erase(Key(fd, Timers::IDLE));
+    active_.erase(Key(fd, Timers::CGI));
+}
+
+// ----------------------------------------------------------------------------
+// Expiry
+// ----------------------------------------------------------------------------
+
+int TimerQueue::next_timeout_ms(long now_ms, int max_timeout_ms) {
+    discard_stale_top();
+    if (heap_.empty()) {
+        return max_timeout_ms;
+    }
+
+    long remaining = heap_.front().deadline_ms - now_ms;
+    if (remaining <= 0) {
+        return 0;
+    }
+    return remaining < max_timeout_ms ? static_cast<int>(remaining) : max_timeout_ms;
+}
+
+bool TimerQueue::pop_expired(long now_ms, int& fd, Timers::Type& type) {
+    discard_stale_top();
+    if (heap_.empty() || heap_.front().deadline_ms > now_ms) {
+        return false;
+    }
+
+    fd = heap_.front().fd;
+    type = heap_.front().type;
+
+    active_.erase(Key(fd, type));
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    heap_.pop_back();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Stale entry handling
+// ----------------------------------------------------------------------------
+
+bool TimerQueue::is_live(const Entry& entry) const {
+    EntryMap::const_iterator it = active_.find(Key(entry.fd, entry.type));
+    return it != active_.end() && it->second.sequence == entry.sequence;
+}
+
+void TimerQueue::discard_stale_top() {
+    while (!heap_.empty() && !is_live(heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        heap_.pop_back();
+    }
+}
+
+void TimerQueue::compact() {
+    heap_.clear();
+    for (EntryMap::const_iterator it = active_.begin(); it != active_.end(); ++it) {
+        heap_.push_back(it->second);
+    }
+    std::make_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+}
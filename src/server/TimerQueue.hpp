@@ -0,0 +1,74 @@
+#ifndef TIMERQUEUE_HPP
+#define TIMERQUEUE_HPP
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Deadlines the event loop tracks per file descriptor
+namespace Timers {
+    enum Type {
+        NONE = 0,  // Not a timer event
+        IDLE,      // Connection idle / keep-alive / request timeout
+        CGI        // CGI execution timeout and reap retries
+    };
+}  // namespace Timers
+
+/**
+ * Min-heap of deadlines keyed by (fd, type).
+ *
+ * Each key holds at most one live deadline: scheduling again replaces it and
+ * cancelling forgets it. Replaced and cancelled entries stay in the heap and are
+ * skipped when they reach the top, so every operation is O(log n) and the loop only
+ * pays for timers that actually expire. The heap is rebuilt when stale entries
+ * outnumber live ones.
+ */
+class TimerQueue {
+   public:
+    TimerQueue();
+
+    void schedule(int fd, Timers::Type type, long deadline_ms);
+    void cancel(int fd, Timers::Type type);
+    void cancel_all(int fd);
+
+    // Milliseconds until the nearest deadline, capped at max_timeout_ms
+    int next_timeout_ms(long now_ms, int max_timeout_ms);
+
+    // Remove the nearest expired deadline, returns false when none has expired
+    bool pop_expired(long now_ms, int& fd, Timers::Type& type);
+
+    size_t size() const {
+        return active_.size();
+    }
+
+   private:
+    static const size_t COMPACT_THRESHOLD = 64;  // Minimum heap size worth compacting
+
+    struct Entry {
+        long deadline_ms;
+        unsigned long sequence;  // Distinguishes a live entry from replaced ones
+        int fd;
+        Timers::Type type;
+
+        bool operator>(const Entry& other) const {
+            if (deadline_ms != other.deadline_ms) {
+                return deadline_ms > other.deadline_ms;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    typedef std::pair<int, Timers::Type> Key;
+    typedef std::map<Key, Entry> EntryMap;
+
+    std::vector<Entry> heap_;  // Binary min-heap, may contain stale entries
+    EntryMap active_;          // Live entry per key
+    unsigned long next_sequence_;
+
+    bool is_live(const Entry& entry) const;
+    void discard_stale_top();
+    void compact();
+};
+
+#endif  // TIMERQUEUE_HPP
@@ -0,0 +1,154 @@
+#include "VirtualHosts.hpp"
+
+#include <cstring>
+
+#include "../config/contexts/ServerBlock.hpp"
+
+const size_t VirtualHosts::MAX_HOST_LENGTH;
+
+static const size_t INITIAL_TABLE_SIZE = 16;  // Slots of a name table on first insert
+
+VirtualHosts::VirtualHosts() : default_(NULL) {
+}
+
+void VirtualHosts::add_server(const ServerBlock* block) {
+    for (StringVectorConstIt it = block->server_names.begin(); it != block->server_names.end();
+         ++it) {
+        add_name(block->normalize_server_name(*it), block);
+    }
+}
+
+void VirtualHosts::set_default(const ServerBlock* block) {
+    default_ = block;
+}
+
+void VirtualHosts::add_name(const std::string& name, const ServerBlock* block) {
+    if (name.size() > 2 && name[0] == '*' && name[1] == '.') {
+        leading_.insert(name.substr(1), block);
+    } else if (name.size() > 2 && name[name.size() - 2] == '.' && name[name.size() - 1] == '*') {
+        trailing_.insert(name.substr(0, name.size() - 1), block);
+    } else if (!name.empty()) {
+        exact_.insert(name, block);
+    }
+}
+
+const ServerBlock* VirtualHosts::find(const char* host, size_t length) const {
+    // Drop the port: after the closing bracket of an IPv6 literal, otherwise at the colon
+    const char* end = NULL;
+    if (length > 0 && host[0] == '[') {
+        end = static_cast<const char*>(std::memchr(host, ']', length));
+        if (end) {
+            end++;
+        }
+    } else {
+        end = static_cast<const char*>(std::memchr(host, ':', length));
+    }
+    size_t name_length = end ? static_cast<size_t>(end - host) : length;
+    while (name_length > 0 && host[name_length - 1] == '.') {
+        name_length--;
+    }
+    if (name_length == 0 || name_length > MAX_HOST_LENGTH) {
+        return default_;
+    }
+
+    // Normalized copy: lowercase, no trailing dot
+    char name[MAX_HOST_LENGTH];
+    for (size_t i = 0; i < name_length; ++i) {
+        char c = host[i];
+        name[i] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    const ServerBlock* block = exact_.find(name, name_length);
+    if (block) {
+        return block;
+    }
+
+    // Longest leading wildcard first: suffixes from the leftmost dot on
+    if (!leading_.empty()) {
+        for (size_t i = 1; i < name_length; ++i) {
+            if (name[i] == '.' && (block = leading_.find(name + i, name_length - i))) {
+                return block;
+            }
+        }
+    }
+
+    // Longest trailing wildcard first: prefixes up to the rightmost dot
+    if (!trailing_.empty()) {
+        for (size_t i = name_length - 1; i > 0; --i) {
+            if (name[i] == '.' && (block = trailing_.find(name, i + 1))) {
+                return block;
+            }
+        }
+    }
+
+    return default_;
+}
+
+// ------------------------------------------------------------------
+// Name table
+
+VirtualHosts::NameTable::NameTable() : count_(0) {
+}
+
+// FNV-1a
+size_t VirtualHosts::NameTable::hash(const char* name, size_t length) {
+    size_t value = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        value ^= static_cast<unsigned char>(name[i]);
+        value *= 16777619u;
+    }
+    return value;
+}
+
+void VirtualHosts::NameTable::insert(const std::string& name, const ServerBlock* block) {
+    if ((count_ + 1) * 2 > entries_.size()) {
+        grow();
+    }
+
+    size_t name_hash = hash(name.data(), name.size());
+    size_t mask = entries_.size() - 1;
+    for (size_t i = name_hash & mask;; i = (i + 1) & mask) {
+        Entry& entry = entries_[i];
+        if (!entry.block) {
+            entry.name = name;
+            entry.hash = name_hash;
+            entry.block = block;
+            count_++;
+            return;
+        }
+        if (entry.hash == name_hash && entry.name == name) {
+            return;  // The first block keeps the name
+        }
+    }
+}
+
+const ServerBlock* VirtualHosts::NameTable::find(const char* name, size_t length) const {
+    if (count_ == 0) {
+        return NULL;
+    }
+
+    size_t name_hash = hash(name, length);
+    size_t mask = entries_.size() - 1;
+    for (size_t i = name_hash & mask;; i = (i + 1) & mask) {
+        const Entry& entry = entries_[i];
+        if (!entry.block) {
+            return NULL;
+        }
+        if (entry.hash == name_hash && entry.name.size() == length &&
+            std::memcmp(entry.name.data(), name, length) == 0) {
+            return entry.block;
+        }
+    }
+}
+
+void VirtualHosts::NameTable::grow() {
+    std::vector<Entry> old_entries;
+    old_entries.swap(entries_);
+    entries_.resize(old_entries.empty() ? INITIAL_TABLE_SIZE : old_entries.size() * 2);
+    count_ = 0;
+    for (size_t i = 0; i < old_entries.size(); ++i) {
+        if (old_entries[i].block) {
+            insert(old_entries[i].name, old_entries[i].block);
+        }
+    }
+}
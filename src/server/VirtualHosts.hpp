@@ -0,0 +1,77 @@
+#ifndef VIRTUAL_HOSTS_HPP
+#define VIRTUAL_HOSTS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ServerBlock;
+
+/**
+ * Server blocks of one listening port by server_name, built once at startup.
+ *
+ * Names are stored normalized (lowercase, no trailing dot) in open addressing hash tables,
+ * one per kind of name, as nginx orders them:
+ * - exact names ("www.example.com")
+ * - leading wildcards ("*.example.com"), stored as ".example.com" and probed with each
+ *   suffix of the host that starts at a dot, longest first
+ * - trailing wildcards ("www.example.*"), stored as "www.example." and probed with each
+ *   prefix of the host that ends at a dot, longest first
+ *
+ * find() normalizes the Host value into a stack buffer and hashes it in place, so a lookup
+ * allocates nothing: one probe for an exact name, one per dot for a wildcard. A host that
+ * matches no name gets the default server of the port.
+ */
+class VirtualHosts {
+   public:
+    static const size_t MAX_HOST_LENGTH = 255;  // Longer Host values get the default server
+
+    VirtualHosts();
+
+    // Register the server_names of a block, the first block to claim a name keeps it
+    void add_server(const ServerBlock* block);
+    void set_default(const ServerBlock* block);
+    const ServerBlock* get_default() const {
+        return default_;
+    }
+
+    // Server block for a Host header value, port included, the default one when none matches
+    const ServerBlock* find(const char* host, size_t length) const;
+
+   private:
+    class NameTable {
+       public:
+        NameTable();
+
+        void insert(const std::string& name, const ServerBlock* block);
+        const ServerBlock* find(const char* name, size_t length) const;
+        bool empty() const {
+            return count_ == 0;
+        }
+
+       private:
+        struct Entry {
+            std::string name;
+            size_t hash;
+            const ServerBlock* block;  // NULL for a free slot
+
+            Entry() : hash(0), block(NULL) {
+            }
+        };
+
+        std::vector<Entry> entries_;  // Size is a power of two, at most half full
+        size_t count_;
+
+        static size_t hash(const char* name, size_t length);
+        void grow();
+    };
+
+    NameTable exact_;             // "www.example.com"
+    NameTable leading_;           // "*.example.com" as ".example.com"
+    NameTable trailing_;          // "www.example.*" as "www.example."
+    const ServerBlock* default_;  // Port's default server
+
+    void add_name(const std::string& name, const ServerBlock* block);
+};
+
+#endif  // VIRTUAL_HOSTS_HPP
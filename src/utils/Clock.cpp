@@ -0,0 +1,61 @@
+#include "Clock.hpp"
+
+#include <sys/time.h>
+
+// Every reactor thread runs its own loop, so the cache is per thread
+namespace {
+    const size_t HTTP_DATE_SIZE = 32;  // "Sun, 06 Nov 1994 08:49:37 GMT" + NUL
+
+    __thread time_t g_wall_seconds = 0;  // Cached wall-clock time
+    __thread long g_monotonic_ms = 0;    // Cached monotonic time
+    __thread bool g_initialized = false;
+
+    __thread time_t g_date_seconds = -1;        // Second the cached Date string was built for
+    __thread char g_http_date[HTTP_DATE_SIZE];  // Cached HTTP-date string
+
+    long read_monotonic_ms() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<long>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+
+    void ensure_initialized() {
+        if (!g_initialized) {
+            Clock::update();
+        }
+    }
+}  // namespace
+
+namespace Clock {
+
+    long update() {
+        g_wall_seconds = time(NULL);
+        g_monotonic_ms = read_monotonic_ms();
+        g_initialized = true;
+        return g_monotonic_ms;
+    }
+
+    time_t now() {
+        ensure_initialized();
+        return g_wall_seconds;
+    }
+
+    long now_ms() {
+        ensure_initialized();
+        return g_monotonic_ms;
+    }
+
+    std::string http_date() {
+        ensure_initialized();
+        if (g_date_seconds != g_wall_seconds) {
+            struct tm tm_info;
+            gmtime_r(&g_wall_seconds, &tm_info);
+
+            // Format according to HTTP spec
+            strftime(g_http_date, HTTP_DATE_SIZE, "%a, %d %b %Y %H:%M:%S GMT", &tm_info);
+            g_date_seconds = g_wall_seconds;
+        }
+        return g_http_date;
+    }
+
+}  // namespace Clock
@@ -0,0 +1,29 @@
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <ctime>
+#include <string>
+
+/**
+ * Coarse clock cached once per event loop iteration.
+ *
+ * Hot paths (activity timestamps, timers, the Date header) read the cached values
+ * instead of issuing a clock syscall each time. Clock::update() is called by the
+ * event poller right after every wait. The cache is thread-local: each reactor thread
+ * sees the time of its own last wakeup.
+ */
+namespace Clock {
+    // Refresh the cached time, returns the new monotonic time in milliseconds
+    long update();
+
+    // Wall-clock seconds since the epoch (for logs, file names, Date)
+    time_t now();
+
+    // Monotonic milliseconds since an arbitrary start point (for deadlines)
+    long now_ms();
+
+    // Current time formatted as an HTTP-date, regenerated once per second
+    std::string http_date();
+}  // namespace Clock
+
+#endif  // CLOCK_HPP
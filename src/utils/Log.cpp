@@ -76,18 +76,21 @@ namespace Log {
         if (current_level_ > DEBUG) {
             return;
         }
-        std::string method = HttpMethods::to_string(request.get_method());
-        std::string path = request.get_path();
-        std::string version = request.get_http_version();
-        std::string user_agent = request.get_header("User-Agent");
-
-        std::string message = "REQ " + method + " " + path + " " + version;
-        if (!user_agent.empty()) {
-            // Truncate long user agents for readability
-            if (user_agent.length() > MAX_USER_AGENT_LENGTH) {
-                user_agent = user_agent.substr(0, USER_AGENT_TRUNCATE_LENGTH) + "...";
+        std::string message = "REQ " + HttpMethods::to_string(request.get_method()) + " " +
+                              request.get_path() + " " + request.get_http_version();
+
+        // User agent straight from the header table, truncated if long for readability
+        const HeaderTable& headers = request.get_headers();
+        size_t index = headers.find(HttpHeaders::USER_AGENT);
+        if (index < headers.size() && headers.value_at(index).length > 0) {
+            HeaderTable::Slice user_agent = headers.value_at(index);
+            message += " (";
+            if (user_agent.length > MAX_USER_AGENT_LENGTH) {
+                message.append(user_agent.data, USER_AGENT_TRUNCATE_LENGTH).append("...");
+            } else {
+                message.append(user_agent.data, user_agent.length);
             }
-            message += " (" + user_agent + ")";
+            message += ")";
         }
 
         internal::log(DEBUG, message);
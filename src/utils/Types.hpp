@@ -11,7 +11,9 @@
 class ServerBlock;
 class LocationBlock;
 class Connection;
+class Reactor;
 class Socket;
+class VirtualHosts;
 struct PollResult;
 
 // HTTP-related types
@@ -33,8 +35,8 @@ typedef std::map<std::string, std::string> CgiHandlerMap;  // extension -> handl
 // Server runtime types
 typedef std::map<int, Socket> SocketMap;                    // port -> Socket
 typedef std::map<int, Connection*> ConnectionMap;           // fd -> Connection*
-typedef std::map<int, const ServerBlock*> DefaultBlockMap;  // port -> default ServerBlock*
-typedef std::map<int, short> EventMap;                      // fd -> events
+typedef std::vector<Reactor*> ReactorVector;
+typedef std::map<int, VirtualHosts> VirtualHostMap;         // port -> server blocks by name
 typedef std::vector<PollResult> PollResultVector;
 
 // CGI-related types
@@ -66,7 +68,7 @@ typedef SocketMap::iterator SocketMapIt;
 typedef SocketMap::const_iterator SocketMapConstIt;
 typedef ConnectionMap::iterator ConnectionMapIt;
 typedef ConnectionMap::const_iterator ConnectionMapConstIt;
-typedef DefaultBlockMap::const_iterator DefaultBlockMapConstIt;
+typedef VirtualHostMap::const_iterator VirtualHostMapConstIt;
 
 // Configuration iterator types
 typedef ServerBlockVector::iterator ServerBlockVectorIt;